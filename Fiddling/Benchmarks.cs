@@ -0,0 +1,165 @@
+using System;
+using System.Diagnostics;
+using System.Linq;
+using Noesis.Javascript;
+
+namespace Fiddling
+{
+    /// <summary>
+    /// Rough timings for comparing changes to the marshalling and entry paths.
+    /// Run with "Fiddling.exe benchmark", in Release and without a debugger.
+    /// </summary>
+    static class Benchmarks
+    {
+        const int Iterations = 10000;
+
+        public static void Run()
+        {
+            using (JavascriptContext context = new JavascriptContext()) {
+                Measure("individual calls", () => ManyCalls(context));
+                Measure("one session", () => {
+                    using (JavascriptSession session = context.BeginSession())
+                        ManyCalls(session);
+                });
+
+                MeasureConversion(context, "int[]", Enumerable.Range(0, ArrayLength).ToArray());
+                MeasureConversion(context, "string[]", Enumerable.Range(0, ArrayLength).Select(i => "item " + i).ToArray());
+                MeasureConversion(context, "DateTime[]", Enumerable.Range(0, ArrayLength).Select(i => new DateTime(2000, 1, 1).AddMinutes(i)).ToArray());
+                MeasureConversion(context, "Poco[]", Enumerable.Range(0, ArrayLength).Select(i => new Poco { Id = i, Name = "item " + i }).ToArray());
+
+                MeasureFrames(context);
+
+                MeasureNumberArrays(context);
+
+                MeasureStrings(context);
+
+                MeasureWrapperChurn(context);
+            }
+        }
+
+        // Passes a 50MB double[] in and reads it back out.
+        static void MeasureFrames(JavascriptContext context)
+        {
+            const int repeats = 10;
+            double[] frame = new double[50 * 1024 * 1024 / sizeof(double)];
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            for (int i = 0; i < repeats; i++) {
+                context.SetParameter("frame", frame);
+                context.GetParameter("frame");
+            }
+            stopwatch.Stop();
+            Console.WriteLine("{0,-20} {1,8:F2} ms/round trip", "50MB double[]", stopwatch.Elapsed.TotalMilliseconds / repeats);
+        }
+
+        // Reads a script's array of 1M doubles back, boxed and unboxed.
+        static void MeasureNumberArrays(JavascriptContext context)
+        {
+            const int repeats = 10;
+            context.Run("var numbers = []; for (var i = 0; i < 1000000; i++) numbers.push(i / 3);");
+            foreach (bool typed in new[] { false, true }) {
+                Stopwatch stopwatch = Stopwatch.StartNew();
+                for (int i = 0; i < repeats; i++) {
+                    if (typed)
+                        context.GetParameter<double[]>("numbers");
+                    else
+                        context.GetParameter("numbers");
+                }
+                stopwatch.Stop();
+                Console.WriteLine("{0,-20} {1,8:F2} ms/1M", typed ? "double[] (typed)" : "object[]",
+                    stopwatch.Elapsed.TotalMilliseconds / repeats);
+            }
+        }
+
+        // Passes Latin-1 and wider strings of various lengths in and back
+        // out, all short enough to be copied rather than shared.
+        static void MeasureStrings(JavascriptContext context)
+        {
+            foreach (int length in new[] { 16, 256, 4096, 60000 }) {
+                foreach (char c in new[] { 'x', '\u20ac' }) {
+                    string value = new string(c, length);
+                    int repeats = 10000000 / length;
+                    Stopwatch stopwatch = Stopwatch.StartNew();
+                    for (int i = 0; i < repeats; i++) {
+                        context.SetParameter("value", value);
+                        context.GetParameter("value");
+                    }
+                    stopwatch.Stop();
+                    Console.WriteLine("{0,-20} {1,8:F2} us/round trip", String.Format("string {0} {1}", length, c == 'x' ? "latin1" : "wide"),
+                        stopwatch.Elapsed.TotalMilliseconds * 1000 / repeats);
+                }
+            }
+        }
+
+        // Wraps millions of short-lived objects in one context.  Private
+        // bytes should stay flat from one round to the next.
+        static void MeasureWrapperChurn(JavascriptContext context)
+        {
+            const int rounds = 5, perRound = 1000000;
+            for (int round = 0; round < rounds; round++) {
+                Stopwatch stopwatch = Stopwatch.StartNew();
+                for (int i = 0; i < perRound; i++) {
+                    context.SetParameter("row", new Poco { Id = i });
+                    context.GetParameter("row");
+                }
+                context.Collect();
+                GC.Collect();
+                Console.WriteLine("wrapper churn {0}      {1,8:F2} M wraps/s, {2,6} MB private", round,
+                    perRound / stopwatch.Elapsed.TotalSeconds / 1e6,
+                    Process.GetCurrentProcess().PrivateMemorySize64 / 1048576);
+            }
+        }
+
+        const int ArrayLength = 100000;
+
+        public class Poco
+        {
+            public int Id { get; set; }
+            public string Name { get; set; }
+        }
+
+        // Reports values converted to v8 per second.
+        static void MeasureConversion(JavascriptContext context, string name, Array values)
+        {
+            const int repeats = 20;
+            context.SetParameter("values", values);  // warm up
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            for (int i = 0; i < repeats; i++)
+                context.SetParameter("values", values);
+            stopwatch.Stop();
+            Console.WriteLine("{0,-20} {1,8:F2} M values/s", name,
+                (double)repeats * values.Length / stopwatch.Elapsed.TotalSeconds / 1e6);
+        }
+
+        static void ManyCalls(JavascriptContext context)
+        {
+            for (int i = 0; i < Iterations; i++) {
+                for (int j = 0; j < 20; j++)
+                    context.SetParameter("p" + j, j);
+                context.Run("var total = p0 + p19;");
+                for (int j = 0; j < 10; j++)
+                    context.GetParameter("p" + j);
+            }
+        }
+
+        static void ManyCalls(JavascriptSession session)
+        {
+            for (int i = 0; i < Iterations; i++) {
+                for (int j = 0; j < 20; j++)
+                    session.SetParameter("p" + j, j);
+                session.Run("var total = p0 + p19;");
+                for (int j = 0; j < 10; j++)
+                    session.GetParameter("p" + j);
+            }
+        }
+
+        static void Measure(string name, Action action)
+        {
+            action();  // warm up
+            Stopwatch stopwatch = Stopwatch.StartNew();
+            action();
+            stopwatch.Stop();
+            Console.WriteLine("{0,-20} {1,8:F2} us/iteration", name,
+                stopwatch.Elapsed.TotalMilliseconds * 1000 / Iterations);
+        }
+    }
+}
@@ -20,6 +20,10 @@ namespace Fiddling
 
         static void Main(string[] args)
         {
+            if (args.Length > 0 && args[0] == "benchmark") {
+                Benchmarks.Run();
+                return;
+            }
 
             JavascriptContext.SetFatalErrorHandler(FatalErrorHandler);
             using (JavascriptContext context = new JavascriptContext()) {
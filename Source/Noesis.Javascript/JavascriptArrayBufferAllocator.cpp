@@ -0,0 +1,203 @@
+#include <windows.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JavascriptArrayBufferAllocator.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// The shared free lists.  Class i holds blocks of (kMinimumBlock << i)
+// bytes; anything bigger than the largest class goes straight to the CRT.
+// Each class has its own lock, so isolates only contend when they churn
+// buffers of similar sizes at the same moment.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const size_t kMinimumBlock = 16;
+static const int kSizeClasses = 13;  // up to 64KB
+static const size_t kMaximumPooledBytesPerClass = 1024 * 1024;
+
+struct FreeBlock
+{
+	FreeBlock *next;
+};
+
+struct SizeClass
+{
+	SRWLOCK lock;
+	FreeBlock *head;
+	size_t count;
+};
+
+static SizeClass sSizeClasses[kSizeClasses] = {};  // SRWLOCK_INIT is all zeroes
+
+static std::atomic<long long> sPooledBytes;
+static std::atomic<long long> sPoolHits;
+static std::atomic<long long> sPoolMisses;
+
+static int GetSizeClass(size_t length)
+{
+	size_t block = kMinimumBlock;
+	for (int i = 0; i < kSizeClasses; i++, block <<= 1)
+		if (length <= block)
+			return i;
+	return -1;
+}
+
+static void *TakeBlock(size_t length)
+{
+	int index = GetSizeClass(length);
+	if (index < 0)
+		return malloc(length);
+
+	SizeClass &sizeClass = sSizeClasses[index];
+	FreeBlock *block;
+	AcquireSRWLockExclusive(&sizeClass.lock);
+	block = sizeClass.head;
+	if (block != NULL)
+	{
+		sizeClass.head = block->next;
+		sizeClass.count--;
+	}
+	ReleaseSRWLockExclusive(&sizeClass.lock);
+
+	if (block == NULL)
+	{
+		sPoolMisses++;
+		return malloc(kMinimumBlock << index);
+	}
+	sPoolHits++;
+	sPooledBytes -= (long long)(kMinimumBlock << index);
+	return block;
+}
+
+static void ReturnBlock(void *data, size_t length)
+{
+	int index = GetSizeClass(length);
+	if (index < 0)
+	{
+		free(data);
+		return;
+	}
+
+	size_t blockSize = kMinimumBlock << index;
+	SizeClass &sizeClass = sSizeClasses[index];
+	bool pooled = false;
+	AcquireSRWLockExclusive(&sizeClass.lock);
+	if ((sizeClass.count + 1) * blockSize <= kMaximumPooledBytesPerClass)
+	{
+		FreeBlock *block = (FreeBlock *)data;
+		block->next = sizeClass.head;
+		sizeClass.head = block;
+		sizeClass.count++;
+		pooled = true;
+	}
+	ReleaseSRWLockExclusive(&sizeClass.lock);
+
+	if (pooled)
+		sPooledBytes += (long long)blockSize;
+	else
+		free(data);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptArrayBufferAllocator::JavascriptArrayBufferAllocator(size_t iCap)
+	: mCap(iCap), mBytesInUse(0), mPeakBytesInUse(0), mAllocationCount(0), mFailedAllocationCount(0)
+{
+}
+
+JavascriptArrayBufferAllocator::~JavascriptArrayBufferAllocator()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void *
+JavascriptArrayBufferAllocator::Allocate(size_t length)
+{
+	void *data = AllocateUninitialized(length);
+	if (data != NULL)
+		memset(data, 0, length);
+	return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void *
+JavascriptArrayBufferAllocator::AllocateUninitialized(size_t length)
+{
+	if (!Reserve(length))
+		return NULL;
+	void *data = TakeBlock(length);
+	if (data == NULL)
+		mBytesInUse -= (long long)length;
+	return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptArrayBufferAllocator::Free(void *data, size_t length)
+{
+	if (data == NULL)
+		return;
+	ReturnBlock(data, length);
+	mBytesInUse -= (long long)length;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool
+JavascriptArrayBufferAllocator::Reserve(size_t iLength)
+{
+	long long inUse = (mBytesInUse += (long long)iLength);
+	if (mCap != 0 && (size_t)inUse > mCap)
+	{
+		mBytesInUse -= (long long)iLength;
+		mFailedAllocationCount++;
+		return false;
+	}
+	mAllocationCount++;
+
+	long long peak = mPeakBytesInUse;
+	while (inUse > peak && !mPeakBytesInUse.compare_exchange_weak(peak, inUse))
+		;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+long long
+JavascriptArrayBufferAllocator::GetPooledBytes()
+{
+	return sPooledBytes;
+}
+
+long long
+JavascriptArrayBufferAllocator::GetPoolHits()
+{
+	return sPoolHits;
+}
+
+long long
+JavascriptArrayBufferAllocator::GetPoolMisses()
+{
+	return sPoolMisses;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(pop)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+#include <atomic>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptArrayBufferAllocator
+//
+// Backing store for ArrayBuffers.  Each isolate gets its own instance, which
+// counts the bytes its scripts have allocated and can refuse to go past a
+// cap (the script sees a RangeError).  Small buffers come from size-class
+// free lists shared by every isolate in the process, so scripts that churn
+// typed arrays mostly avoid the CRT heap.
+//
+// Everything here is native code, because v8 calls it directly.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class JavascriptArrayBufferAllocator : public v8::ArrayBuffer::Allocator
+{
+	////////////////////////////////////////////////////////////
+	// Constructor
+	////////////////////////////////////////////////////////////
+public:
+
+	// A cap of zero means no cap.
+	JavascriptArrayBufferAllocator(size_t iCap);
+
+	virtual ~JavascriptArrayBufferAllocator();
+
+	////////////////////////////////////////////////////////////
+	// v8::ArrayBuffer::Allocator
+	////////////////////////////////////////////////////////////
+public:
+
+	virtual void *Allocate(size_t length);
+
+	virtual void *AllocateUninitialized(size_t length);
+
+	virtual void Free(void *data, size_t length);
+
+	////////////////////////////////////////////////////////////
+	// Counters
+	////////////////////////////////////////////////////////////
+public:
+
+	long long GetBytesInUse() { return mBytesInUse; }
+
+	long long GetPeakBytesInUse() { return mPeakBytesInUse; }
+
+	long long GetAllocationCount() { return mAllocationCount; }
+
+	// Allocations refused because of the cap.
+	long long GetFailedAllocationCount() { return mFailedAllocationCount; }
+
+	// Process-wide figures for the shared free lists.
+	static long long GetPooledBytes();
+
+	static long long GetPoolHits();
+
+	static long long GetPoolMisses();
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	// Returns false if iLength would take us past the cap.
+	bool Reserve(size_t iLength);
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	size_t mCap;
+
+	std::atomic<long long> mBytesInUse;
+	std::atomic<long long> mPeakBytesInUse;
+	std::atomic<long long> mAllocationCount;
+	std::atomic<long long> mFailedAllocationCount;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,154 @@
+#include "JavascriptCodeCache.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace v8;
+using namespace System::IO;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptCodeCache::Enable(System::String^ iDirectory)
+{
+	if (iDirectory == nullptr)
+		throw gcnew System::ArgumentNullException("iDirectory");
+	System::IO::Directory::CreateDirectory(iDirectory);
+	sDirectory = iDirectory;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptCodeCache::Disable()
+{
+	sDirectory = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::String^
+JavascriptCodeCache::GetKey(wchar_t const *iSourceCode, int iLength)
+{
+	if (sDirectory == nullptr || iLength < sMinimumSourceLength)
+		return nullptr;
+
+	cli::array<System::Byte>^ bytes = gcnew cli::array<System::Byte>(iLength * sizeof(wchar_t));
+	System::Runtime::InteropServices::Marshal::Copy(System::IntPtr((void *)iSourceCode), bytes, 0, bytes->Length);
+	System::Security::Cryptography::SHA256^ sha = System::Security::Cryptography::SHA256::Create();
+	cli::array<System::Byte>^ hash = sha->ComputeHash(bytes);
+	delete sha;
+
+	// The version tag covers both the v8 version and the flags in effect.
+	return System::BitConverter::ToString(hash)->Replace("-", "")
+		+ "-" + ScriptCompiler::CachedDataVersionTag().ToString("x8");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ScriptCompiler::CachedData *
+JavascriptCodeCache::Load(System::String^ iKey)
+{
+	System::String^ directory = sDirectory;
+	cli::array<System::Byte>^ bytes = nullptr;
+	if (directory != nullptr)
+	{
+		try
+		{
+			bytes = File::ReadAllBytes(Path::Combine(directory, iKey + ".bin"));
+		}
+		catch (IOException^)
+		{
+			// Missing, or being written by someone else.  Compile from source.
+		}
+		catch (System::UnauthorizedAccessException^)
+		{
+		}
+	}
+	if (bytes == nullptr || bytes->Length == 0)
+	{
+		System::Threading::Interlocked::Increment(sMisses);
+		return NULL;
+	}
+
+	uint8_t *data = new uint8_t[bytes->Length];
+	System::Runtime::InteropServices::Marshal::Copy(bytes, 0, System::IntPtr(data), bytes->Length);
+	return new ScriptCompiler::CachedData(data, bytes->Length, ScriptCompiler::CachedData::BufferOwned);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptCodeCache::Store(System::String^ iKey, ScriptCompiler::CachedData *iData)
+{
+	System::String^ directory = sDirectory;
+	if (directory == nullptr || iData == NULL || iData->length <= 0)
+	{
+		delete iData;
+		return;
+	}
+
+	// Copy out now, so the thread pool never touches v8 memory.
+	cli::array<System::Byte>^ bytes = gcnew cli::array<System::Byte>(iData->length);
+	System::Runtime::InteropServices::Marshal::Copy(System::IntPtr((void *)iData->data), bytes, 0, iData->length);
+	delete iData;
+
+	cli::array<System::Object^>^ state = gcnew cli::array<System::Object^> { Path::Combine(directory, iKey + ".bin"), bytes };
+	System::Threading::ThreadPool::QueueUserWorkItem(gcnew System::Threading::WaitCallback(&JavascriptCodeCache::Write), state);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptCodeCache::Consumed(bool iRejected)
+{
+	// A rejected file gets overwritten by the caller via Store(), so there
+	// is nothing to clean up here.
+	if (iRejected)
+		System::Threading::Interlocked::Increment(sRejections);
+	else
+		System::Threading::Interlocked::Increment(sHits);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptCodeCache::Write(System::Object^ iState)
+{
+	cli::array<System::Object^>^ state = safe_cast<cli::array<System::Object^>^>(iState);
+	System::String^ path = safe_cast<System::String^>(state[0]);
+	cli::array<System::Byte>^ bytes = safe_cast<cli::array<System::Byte>^>(state[1]);
+
+	// Write to a private file and then move it into place, so that other
+	// processes sharing the directory never read a partial file.
+	System::String^ temporary = path + "." + System::Guid::NewGuid().ToString("N") + ".tmp";
+	try
+	{
+		File::WriteAllBytes(temporary, bytes);
+		if (File::Exists(path))
+			File::Replace(temporary, path, nullptr);
+		else
+			File::Move(temporary, path);
+	}
+	catch (System::Exception^)
+	{
+		// Most likely another process won the race.  The cache is only an
+		// optimisation, so don't let it take down the thread pool.
+		try
+		{
+			File::Delete(temporary);
+		}
+		catch (System::Exception^)
+		{
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,95 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptCodeCache
+//
+// Persists v8's compiled code for scripts in a directory, so that a new
+// process does not have to compile large scripts from scratch.  Off until
+// Enable() is called.
+//
+// Files are named after a hash of the source plus v8's cached data version
+// tag, which changes with the v8 version and with the flags passed to
+// JavascriptContext::SetFlags().  Stale files are therefore never consulted;
+// clearing out the directory is left to the application.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptCodeCache abstract sealed
+{
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	// The directory is created if necessary.
+	static void Enable(System::String^ iDirectory);
+
+	static void Disable();
+
+	// Null while disabled.
+	property static System::String^ Directory { System::String^ get() { return sDirectory; } }
+
+	// Scripts shorter than this (in characters) are not worth hashing and
+	// are always compiled from source.
+	property static int MinimumSourceLength
+	{
+		int get() { return sMinimumSourceLength; }
+		void set(int value) { sMinimumSourceLength = value; }
+	}
+
+	// Compilations that consumed a cache file.
+	property static long long Hits { long long get() { return System::Threading::Interlocked::Read(sHits); } }
+
+	// Compilations that found no cache file.
+	property static long long Misses { long long get() { return System::Threading::Interlocked::Read(sMisses); } }
+
+	// Compilations whose cache file v8 refused, e.g. because it was corrupt.
+	property static long long Rejections { long long get() { return System::Threading::Interlocked::Read(sRejections); } }
+
+	////////////////////////////////////////////////////////////
+	// Internal methods
+	////////////////////////////////////////////////////////////
+internal:
+
+	// Returns null if the script should not be cached.
+	static System::String^ GetKey(wchar_t const *iSourceCode, int iLength);
+
+	// Returns NULL on a miss.  The caller owns the result.
+	static v8::ScriptCompiler::CachedData *Load(System::String^ iKey);
+
+	// Takes ownership of iData.  The file is written on the thread pool.
+	static void Store(System::String^ iKey, v8::ScriptCompiler::CachedData *iData);
+
+	// Records whether v8 accepted data returned by Load().
+	static void Consumed(bool iRejected);
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	static void Write(System::Object^ iState);
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	static System::String^ sDirectory;
+
+	static int sMinimumSourceLength = 1024;
+
+	static long long sHits, sMisses, sRejections;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
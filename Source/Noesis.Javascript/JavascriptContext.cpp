@@ -37,11 +37,20 @@
 #include "JavascriptContext.h"
 
 #include "SystemInterop.h"
+#include "JavascriptCodeCache.h"
 #include "JavascriptException.h"
 #include "JavascriptExternal.h"
+#include "JavascriptExternalString.h"
 #include "JavascriptFunction.h"
+#include "JavascriptHeapStatistics.h"
 #include "JavascriptInterop.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptPlatform.h"
+#include "JavascriptScript.h"
+#include "JavascriptSession.h"
+#include "JavascriptSnapshot.h"
 #include "JavascriptStackFrame.h"
+#include "JavascriptWatchdog.h"
 
 using namespace msclr;
 using namespace v8::platform;
@@ -107,7 +116,7 @@ namespace Noesis { namespace Javascript {
             GetPathsForInitialisation(dll_path, natives_blob_bin_path, snapshot_blob_bin_path, icudtl_dat_path);
             v8::V8::InitializeICUDefaultLocation(dll_path, icudtl_dat_path);
             v8::V8::InitializeExternalStartupData(natives_blob_bin_path, snapshot_blob_bin_path);
-            v8::Platform *platform = v8::platform::NewDefaultPlatform().release();
+            v8::Platform *platform = CreatePlatform();
             v8::V8::InitializePlatform(platform);
             v8::V8::Initialize();
         }
@@ -115,6 +124,11 @@ namespace Noesis { namespace Javascript {
 #pragma managed(pop)
 
 static JavascriptContext::JavascriptContext()
+{
+    EnsureV8Initialised();
+}
+
+void JavascriptContext::EnsureV8Initialised()
 {
     System::Threading::Mutex mutex(true, "FA12B681-E968-4D3A-833D-43B25865BEF1");
     UnmanagedInitialisation();
@@ -148,44 +162,110 @@ void JavascriptContext::FatalErrorCallbackMember(const char* location, const cha
 
 JavascriptContext::JavascriptContext()
 {
-	// Unfortunately the fatal error handler is not installed early enough to catch
-    // out-of-memory errors while creating new isolates
-    // (see my post Catching V8::FatalProcessOutOfMemory while creating an isolate (SetFatalErrorHandler does not work)).
-    // Also, HeapStatistics are only fetchable per-isolate, so they will not
-    // easily allow us to work out whether we are about to run out (although they
-    // would help us determine how much memory a new isolate used).
-	v8::Isolate::CreateParams create_params;
-	create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
-	isolate = v8::Isolate::New(create_params);
+	Initialise(gcnew JavascriptIsolate(), true);
+}
+
+JavascriptContext::JavascriptContext(JavascriptSnapshot^ snapshot)
+{
+	if (snapshot == nullptr)
+		throw gcnew System::ArgumentNullException("snapshot");
+	Initialise(gcnew JavascriptIsolate(snapshot), true);
+}
+
+JavascriptContext::JavascriptContext(JavascriptHeapLimits^ heapLimits)
+{
+	if (heapLimits == nullptr)
+		throw gcnew System::ArgumentNullException("heapLimits");
+	Initialise(gcnew JavascriptIsolate(heapLimits), true);
+}
+
+JavascriptContext::JavascriptContext(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits)
+{
+	Initialise(gcnew JavascriptIsolate(snapshot, heapLimits), true);
+}
+
+JavascriptContext::JavascriptContext(JavascriptIsolate^ iIsolate, bool iOwnsIsolate)
+{
+	Initialise(iIsolate, iOwnsIsolate);
+}
+
+void JavascriptContext::Initialise(JavascriptIsolate^ iIsolate, bool iOwnsIsolate)
+{
+	mIsolate = iIsolate;
+	mOwnsIsolate = iOwnsIsolate;
+	isolate = iIsolate->GetIsolate();
 	v8::Locker v8ThreadLock(isolate);
 	v8::Isolate::Scope isolate_scope(isolate);
 
-    isolate->SetFatalErrorHandler(FatalErrorCallback);
-
-	mExternals = gcnew System::Collections::Generic::Dictionary<System::Object ^, WrappedJavascriptExternal>();
-	mFunctions = gcnew System::Collections::Generic::List<System::Object ^>();
+	mExternals = gcnew System::Collections::Generic::Dictionary<System::Object ^, WrappedJavascriptExternal>(gcnew ReferenceComparer());
+	mFunctions = gcnew System::Collections::Generic::HashSet<System::Object ^>(gcnew ReferenceComparer());
 	HandleScope scope(isolate);
 	mContext = new Persistent<Context>(isolate, Context::New(isolate));
     terminateRuns = false;
+
+	iIsolate->AddContext(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 JavascriptContext::~JavascriptContext()
 {
+	if (isolate == NULL)
+		return;
 	{
 		v8::Locker v8ThreadLock(isolate);
 		v8::Isolate::Scope isolate_scope(isolate);
 		for each (WrappedJavascriptExternal wrapped in mExternals->Values)
 			delete wrapped.Pointer;
-		for each (JavascriptFunction^ f in mFunctions)
-			delete f;
+		DeleteFunctions();
+		// The isolate may live on, so the context has to be let go of explicitly.
+		mContext->Reset();
 		delete mContext;
+		mContext = NULL;
 		delete mExternals;
 		delete mFunctions;
+		if (!mOwnsIsolate)
+			isolate->ContextDisposedNotification();
 	}
-	if (isolate != NULL)
-		isolate->Dispose();
+	mIsolate->RemoveContext(this);
+	isolate = NULL;
+	if (mOwnsIsolate)
+		delete mIsolate;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptContext::Reset()
+{
+	ThrowIfOutOfMemory();
+	v8::Locker v8ThreadLock(isolate);
+	v8::Isolate::Scope isolate_scope(isolate);
+	for each (WrappedJavascriptExternal wrapped in mExternals->Values)
+		delete wrapped.Pointer;
+	mExternals->Clear();
+	DeleteFunctions();
+
+	// The isolate, and with it the templates and compiled scripts,
+	// survives.  Only the global scope is thrown away.
+	mContext->Reset();
+	delete mContext;
+	isolate->ContextDisposedNotification();
+	HandleScope scope(isolate);
+	mContext = new Persistent<Context>(isolate, Context::New(isolate));
+
+	// A script that was terminated while leased must not poison the next lease.
+	isolate->CancelTerminateExecution();
+	terminateRuns = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptContext::ThrowIfOutOfMemory()
+{
+	if (mIsolate->IsOutOfMemory)
+		throw gcnew JavascriptOutOfMemoryException();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -243,9 +323,16 @@ JavascriptContext::SetParameter(System::String^ iName, System::Object^ iObject,
 {
 	if (iName == nullptr)
 		throw gcnew System::ArgumentNullException("iName");
+	JavascriptScope scope(this);
+	SetParameterInScope(iName, iObject, options);
+}
+
+void
+JavascriptContext::SetParameterInScope(System::String^ iName, System::Object^ iObject, SetParameterOptions options)
+{
+	ThrowIfOutOfMemory();
 	pin_ptr<const wchar_t> namePtr = PtrToStringChars(iName);
 	wchar_t* name = (wchar_t*) namePtr;
-	JavascriptScope scope(this);
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 	HandleScope handleScope(isolate);
 	
@@ -273,80 +360,340 @@ JavascriptContext::GetParameter(System::String^ iName)
 {
 	if (iName == nullptr)
 		throw gcnew System::ArgumentNullException("iName");
+	JavascriptScope scope(this);
+	return GetParameterInScope(iName);
+}
+
+generic <typename T>
+T
+JavascriptContext::GetParameter(System::String^ iName)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	JavascriptScope scope(this);
+	return safe_cast<T>(GetParameterInScope(iName, T::typeid));
+}
+
+System::Object^
+JavascriptContext::GetParameterInScope(System::String^ iName)
+{
+	return GetParameterInScope(iName, nullptr);
+}
+
+System::Object^
+JavascriptContext::GetParameterInScope(System::String^ iName, System::Type^ iResultType)
+{
+	ThrowIfOutOfMemory();
 	pin_ptr<const wchar_t> namePtr = PtrToStringChars(iName);
 	wchar_t* name = (wchar_t*)namePtr;
-	JavascriptScope scope(this);
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 	HandleScope handleScope(isolate);
 	
 	Local<Value> value = Local<Context>::New(isolate, *mContext)->Global()->Get(String::NewFromTwoByte(isolate, (uint16_t*)name, v8::NewStringType::kNormal).ToLocalChecked());
+	if (iResultType != nullptr)
+		return JavascriptInterop::ConvertFromV8(value, iResultType);
 	return JavascriptInterop::ConvertFromV8(value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-System::Object^
-JavascriptContext::Run(System::String^ iScript)
+void
+JavascriptContext::SetParameterJson(System::String^ iName, cli::array<System::Byte>^ iUtf8Json)
 {
-	if (iScript == nullptr)
-		throw gcnew System::ArgumentNullException("iScript");
-	if (terminateRuns)
-		throw gcnew JavascriptException(L"Execution terminated");
-	pin_ptr<const wchar_t> scriptPtr = PtrToStringChars(iScript);
-	wchar_t* script = (wchar_t*)scriptPtr;
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	if (iUtf8Json == nullptr)
+		throw gcnew System::ArgumentNullException("iUtf8Json");
 	JavascriptScope scope(this);
-	//SetStackLimit();
+	SetParameterJsonInScope(iName, iUtf8Json);
+}
+
+void
+JavascriptContext::SetParameterJsonInScope(System::String^ iName, cli::array<System::Byte>^ iUtf8Json)
+{
+	ThrowIfOutOfMemory();
+	pin_ptr<const wchar_t> namePtr = PtrToStringChars(iName);
+	wchar_t* name = (wchar_t*) namePtr;
+	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 	HandleScope handleScope(isolate);
-	MaybeLocal<Value> ret;
-	
-	Local<Script> compiledScript = CompileScript(isolate, script);
+	Local<Context> context = Local<Context>::New(isolate, *mContext);
+
+	// JSON.parse() would reject a byte order mark.
+	int start = 0;
+	if (iUtf8Json->Length >= 3 && iUtf8Json[0] == 0xEF && iUtf8Json[1] == 0xBB && iUtf8Json[2] == 0xBF)
+		start = 3;
+	Local<String> json = String::Empty(isolate);
+	if (iUtf8Json->Length > start)
+	{
+		pin_ptr<System::Byte> bytes = &iUtf8Json[start];
+		if (!String::NewFromUtf8(isolate, (const char *) bytes, v8::NewStringType::kNormal, iUtf8Json->Length - start).ToLocal(&json))
+			throw gcnew System::ArgumentException("Too long for a JavaScript string.", "iUtf8Json");
+	}
 
+	Local<Value> value;
 	{
 		TryCatch tryCatch(isolate);
-		ret = (*compiledScript)->Run(this->GetCurrentIsolate()->GetCurrentContext());
+		if (!v8::JSON::Parse(context, json).ToLocal(&value))
+		{
+			ThrowIfOutOfMemory();
+			throw gcnew JavascriptException(tryCatch);
+		}
+	}
 
-		if (ret.IsEmpty())
+	v8::Local<v8::String> key = String::NewFromTwoByte(isolate, (uint16_t*)name, v8::NewStringType::kNormal).ToLocalChecked();
+	context->Global()->Set(context, key, value).ToChecked();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<System::Byte>^
+JavascriptContext::GetParameterJson(System::String^ iName)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	JavascriptScope scope(this);
+	return GetParameterJsonInScope(iName);
+}
+
+cli::array<System::Byte>^
+JavascriptContext::GetParameterJsonInScope(System::String^ iName)
+{
+	ThrowIfOutOfMemory();
+	pin_ptr<const wchar_t> namePtr = PtrToStringChars(iName);
+	wchar_t* name = (wchar_t*) namePtr;
+	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
+	HandleScope handleScope(isolate);
+	Local<Context> context = Local<Context>::New(isolate, *mContext);
+
+	Local<String> json;
+	{
+		// toJSON() methods and getters can throw, as can cycles.
+		TryCatch tryCatch(isolate);
+		Local<Value> value;
+		if (!context->Global()->Get(context, String::NewFromTwoByte(isolate, (uint16_t*)name, v8::NewStringType::kNormal).ToLocalChecked()).ToLocal(&value)
+			|| !v8::JSON::Stringify(context, value).ToLocal(&json))
+		{
+			ThrowIfOutOfMemory();
 			throw gcnew JavascriptException(tryCatch);
+		}
 	}
-	
-	return JavascriptInterop::ConvertFromV8(ret.ToLocalChecked());
+
+	// Where JSON.stringify() would return undefined, v8 gives us that word,
+	// which is never valid JSON on its own.
+	if (json->StrictEquals(String::NewFromUtf8(isolate, "undefined", v8::NewStringType::kNormal).ToLocalChecked()))
+		return nullptr;
+
+	int length = json->Utf8Length(isolate);
+	cli::array<System::Byte>^ result = gcnew cli::array<System::Byte>(length);
+	if (length > 0)
+	{
+		pin_ptr<System::Byte> bytes = &result[0];
+		json->WriteUtf8(isolate, (char *) bytes, length, NULL, String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
+	}
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptContext::Run(System::String^ iScript)
+{
+	return Run(iScript, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+generic <typename T>
+T
+JavascriptContext::Run(System::String^ iScript)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	JavascriptScope scope(this);
+	return safe_cast<T>(RunInScope(iScript, nullptr, System::Threading::Timeout::InfiniteTimeSpan, T::typeid));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptContext::Run(System::String^ iScript, System::TimeSpan iTimeout)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	JavascriptScope scope(this);
+	return RunInScope(iScript, nullptr, iTimeout);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 System::Object^
 JavascriptContext::Run(System::String^ iScript, System::String^ iScriptResourceName)
+{
+	return Run(iScript, iScriptResourceName, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptContext::Run(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout)
 {
 	if (iScript == nullptr)
 		throw gcnew System::ArgumentNullException("iScript");
 	if (iScriptResourceName == nullptr)
 		throw gcnew System::ArgumentNullException("iScriptResourceName");
+	JavascriptScope scope(this);
+	return RunInScope(iScript, iScriptResourceName, iTimeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptContext::RunInScope(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout)
+{
+	return RunInScope(iScript, iScriptResourceName, iTimeout, nullptr);
+}
+
+System::Object^
+JavascriptContext::RunInScope(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout, System::Type^ iResultType)
+{
 	if (terminateRuns)
 		throw gcnew JavascriptException(L"Execution terminated");
-	pin_ptr<const wchar_t> scriptPtr = PtrToStringChars(iScript);
-	wchar_t* script = (wchar_t*)scriptPtr;
+	ThrowIfOutOfMemory();
+	//SetStackLimit();
+	HandleScope handleScope(isolate);
+	return RunScript(GetCompiledScript(iScript, iScriptResourceName), iTimeout, iResultType);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSession^
+JavascriptContext::BeginSession()
+{
+	if (IsDisposed())
+		throw gcnew System::ObjectDisposedException("JavascriptContext");
+	return gcnew JavascriptSession(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptScript^
+JavascriptContext::Compile(System::String^ iScript)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	ThrowIfOutOfMemory();
+	JavascriptScope scope(this);
+	HandleScope handleScope(isolate);
+	return gcnew JavascriptScript(CompileUnboundScript(isolate, iScript), this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptScript^
+JavascriptContext::Compile(System::String^ iScript, System::String^ iScriptResourceName)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	if (iScriptResourceName == nullptr)
+		throw gcnew System::ArgumentNullException("iScriptResourceName");
+	ThrowIfOutOfMemory();
 	pin_ptr<const wchar_t> scriptResourceNamePtr = PtrToStringChars(iScriptResourceName);
 	wchar_t* scriptResourceName = (wchar_t*)scriptResourceNamePtr;
 	JavascriptScope scope(this);
-	//SetStackLimit();
 	HandleScope handleScope(isolate);
-	MaybeLocal<Value> ret;	
+	return gcnew JavascriptScript(CompileUnboundScript(isolate, iScript, scriptResourceName), this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Local<UnboundScript>
+JavascriptContext::GetCompiledScript(System::String^ iScript, System::String^ iScriptResourceName)
+{
+	CompiledScriptCache^ compiledScripts = mIsolate->GetCompiledScripts();
+	Local<UnboundScript> compiledScript = compiledScripts->Get(isolate, iScript, iScriptResourceName);
+	if (compiledScript.IsEmpty())
+	{
+		if (iScriptResourceName == nullptr)
+		{
+			compiledScript = CompileUnboundScript(isolate, iScript);
+		}
+		else
+		{
+			pin_ptr<const wchar_t> scriptResourceNamePtr = PtrToStringChars(iScriptResourceName);
+			compiledScript = CompileUnboundScript(isolate, iScript, (wchar_t*)scriptResourceNamePtr);
+		}
+		compiledScripts->Add(isolate, iScript, iScriptResourceName, compiledScript);
+	}
+	return compiledScript;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptContext::RunScript(Local<UnboundScript> iScript)
+{
+	return RunScript(iScript, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+System::Object^
+JavascriptContext::RunScript(Local<UnboundScript> iScript, System::TimeSpan iTimeout)
+{
+	return RunScript(iScript, iTimeout, nullptr);
+}
+
+System::Object^
+JavascriptContext::RunScript(Local<UnboundScript> iScript, System::TimeSpan iTimeout, System::Type^ iResultType)
+{
+	MaybeLocal<Value> ret;
+	Local<Script> compiledScript = iScript->BindToCurrentContext();
 
-	Local<Script> compiledScript = CompileScript(isolate, script, scriptResourceName);
-	
 	{
 		TryCatch tryCatch(isolate);
-		ret = (*compiledScript)->Run(this->GetCurrentIsolate()->GetCurrentContext());
+		JavascriptTimeout timeout(isolate, iTimeout);
+		ret = compiledScript->Run(isolate->GetCurrentContext());
+		timeout.Stop(!ret.IsEmpty());
 
 		if (ret.IsEmpty())
+		{
+			ThrowIfOutOfMemory();
 			throw gcnew JavascriptException(tryCatch);
+		}
 	}
 	
+	if (iResultType != nullptr)
+		return JavascriptInterop::ConvertFromV8(ret.ToLocalChecked(), iResultType);
 	return JavascriptInterop::ConvertFromV8(ret.ToLocalChecked());
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+JavascriptHeapStatistics^
+JavascriptContext::GetHeapStatistics()
+{
+	return mIsolate->GetHeapStatistics();
+}
+
+cli::array<JavascriptHeapSpaceStatistics^>^
+JavascriptContext::GetHeapSpaceStatistics()
+{
+	return mIsolate->GetHeapSpaceStatistics();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int
+JavascriptContext::CompiledScriptCacheSize::get()
+{
+	return mIsolate->GetCompiledScripts()->Capacity;
+}
+
+void
+JavascriptContext::CompiledScriptCacheSize::set(int value)
+{
+	JavascriptScope scope(this);
+	mIsolate->GetCompiledScripts()->Capacity = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 static System::String^ v8StringToString(v8::Handle<v8::String> handle) {
     if (handle.IsEmpty()) {
         return nullptr;
@@ -433,9 +780,17 @@ Handle<v8::Object> JavascriptContext::GetGlobal()
 v8::Locker *
 JavascriptContext::Enter([System::Runtime::InteropServices::Out] JavascriptContext^% old_context)
 {
-	v8::Locker *locker = new v8::Locker(isolate);
-	isolate->Enter();
     old_context = sCurrentContext;
+
+	// Switching between contexts of an isolate this thread already holds
+	// only needs the v8 context switching.
+	v8::Locker *locker = NULL;
+	if (old_context == nullptr || old_context->isolate != isolate)
+	{
+		locker = new v8::Locker(isolate);
+		isolate->Enter();
+		mIsolate->BeginUse();
+	}
 	sCurrentContext = this;
 	HandleScope scope(isolate);
 	Local<Context>::New(isolate, *mContext)->Enter();
@@ -452,17 +807,24 @@ JavascriptContext::Exit(v8::Locker *locker, JavascriptContext^ old_context)
 		Local<Context>::New(isolate, *mContext)->Exit();
 	}
 	sCurrentContext = old_context;
-	isolate->Exit();
-	delete locker;
+	if (locker != NULL)
+	{
+		mIsolate->SampleHeapStatistics();
+		mIsolate->EndUse();
+		isolate->Exit();
+		delete locker;
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Exposed for the benefit of a regression test.
 void
 JavascriptContext::Collect()
 {
-    while(!this->isolate->IdleNotificationDeadline(1)) {};
+	v8::Locker v8ThreadLock(isolate);
+	v8::Isolate::Scope isolate_scope(isolate);
+	isolate->LowMemoryNotification();
+	mIsolate->SampleHeapStatistics();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -478,20 +840,46 @@ JavascriptContext::WrapObject(System::Object^ iObject)
 	}
 	else
 	{
-		JavascriptExternal* external = new JavascriptExternal(iObject);
+		JavascriptExternal* external = new JavascriptExternal(iObject, this);
 		mExternals[iObject] = WrappedJavascriptExternal(external);
 		return external;
 	}
 }
 
+void
+JavascriptContext::ReleaseExternal(JavascriptExternal *iExternal)
+{
+	mExternals->Remove(iExternal->GetObject());
+	delete iExternal;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Handle<ObjectTemplate>
 JavascriptContext::GetObjectWrapperTemplate()
 {
-	if (objectWrapperTemplate == NULL)
-		objectWrapperTemplate = new Persistent<ObjectTemplate>(isolate, JavascriptInterop::NewObjectWrapperTemplate());
-	return Local<ObjectTemplate>::New(isolate, *objectWrapperTemplate);
+	return mIsolate->GetObjectWrapperTemplate();
+}
+
+Handle<ObjectTemplate>
+JavascriptContext::GetObjectWrapperTemplate(System::Type^ iType)
+{
+	return mIsolate->GetObjectWrapperTemplate(iType);
+}
+
+Handle<Function>
+JavascriptContext::GetMethod(System::Type^ iType, System::String^ iName)
+{
+	// v8 makes one function per template and context, so every object of
+	// the type shares it.
+	Local<FunctionTemplate> methodTemplate = mIsolate->GetMethodTemplate(iType, iName);
+	return methodTemplate->GetFunction(GetIsolate()->GetCurrentContext()).ToLocalChecked();
+}
+
+Local<ArrayBuffer>
+JavascriptContext::NewPinnedArrayBuffer(System::Array^ iArray)
+{
+	return mIsolate->NewPinnedArrayBuffer(iArray);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -502,6 +890,23 @@ JavascriptContext::RegisterFunction(System::Object^ f)
 	mFunctions->Add(f);
 }
 
+void
+JavascriptContext::UnregisterFunction(System::Object^ f)
+{
+	mFunctions->Remove(f);
+}
+
+void
+JavascriptContext::DeleteFunctions()
+{
+	// Copied first, because each of them unregisters itself.
+	cli::array<System::Object^>^ functions = gcnew cli::array<System::Object^>(mFunctions->Count);
+	mFunctions->CopyTo(functions);
+	mFunctions->Clear();
+	for each (System::Object^ f in functions)
+		delete f;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 System::String^ JavascriptContext::V8Version::get()
@@ -513,29 +918,72 @@ System::String^ JavascriptContext::V8Version::get()
 
 Local<Script>
 CompileScript(v8::Isolate *isolate, wchar_t const *source_code, wchar_t const *resource_name)
+{
+	return CompileUnboundScript(isolate, source_code, resource_name)->BindToCurrentContext();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static Local<UnboundScript>
+CompileUnboundScript(v8::Isolate *isolate, Local<String> source, wchar_t const *source_code, int source_length, wchar_t const *resource_name);
+
+Local<UnboundScript>
+CompileUnboundScript(v8::Isolate *isolate, wchar_t const *source_code, wchar_t const *resource_name)
 {
 	// convert source
-	Local<String> source = String::NewFromTwoByte(isolate, (uint16_t const *)source_code, v8::NewStringType::kNormal).ToLocalChecked();
+	int source_length = (int)wcslen(source_code);
+	Local<String> source = String::NewFromTwoByte(isolate, (uint16_t const *)source_code, v8::NewStringType::kNormal, source_length).ToLocalChecked();
+	return CompileUnboundScript(isolate, source, source_code, source_length, resource_name);
+}
+
+Local<UnboundScript>
+CompileUnboundScript(v8::Isolate *isolate, System::String^ source_code, wchar_t const *resource_name)
+{
+	// large sources are shared with v8 rather than copied
+	pin_ptr<const wchar_t> source_ptr = PtrToStringChars(source_code);
+	Local<String> source = JavascriptExternalString::New(isolate, source_code);
+	if (source.IsEmpty())
+		source = String::NewFromTwoByte(isolate, (uint16_t const *)source_ptr, v8::NewStringType::kNormal, source_code->Length).ToLocalChecked();
+	return CompileUnboundScript(isolate, source, source_ptr, source_code->Length, resource_name);
+}
+
+static Local<UnboundScript>
+CompileUnboundScript(v8::Isolate *isolate, Local<String> source, wchar_t const *source_code, int source_length, wchar_t const *resource_name)
+{
+	// look for code compiled by an earlier run, maybe in another process
+	System::String^ cache_key = JavascriptCodeCache::GetKey(source_code, source_length);
+	ScriptCompiler::CachedData *cached = NULL;
+	if (cache_key != nullptr)
+		cached = JavascriptCodeCache::Load(cache_key);
+	ScriptCompiler::CompileOptions options = cached == NULL ? ScriptCompiler::kNoCompileOptions : ScriptCompiler::kConsumeCodeCache;
 
 	// compile
 	{
 		TryCatch tryCatch(isolate);
 
-		MaybeLocal<Script> script;
-		if (resource_name == NULL)
-		{
-			script = Script::Compile(JavascriptContext::GetCurrentIsolate()->GetCurrentContext(), source);
-		}
-		else
+		Local<Value> resource;
+		if (resource_name != NULL)
+			resource = String::NewFromTwoByte(isolate, (uint16_t const *)resource_name, v8::NewStringType::kNormal).ToLocalChecked();
+		ScriptOrigin origin(resource);
+		ScriptCompiler::Source compiler_source(source, origin, cached);  // takes ownership of cached
+		MaybeLocal<UnboundScript> script = ScriptCompiler::CompileUnboundScript(isolate, &compiler_source, options);
+
+		if (cached != NULL && !script.IsEmpty())
 		{
-			Local<String> resource = String::NewFromTwoByte(isolate, (uint16_t const *)resource_name, v8::NewStringType::kNormal).ToLocalChecked();
-            ScriptOrigin *origin = new ScriptOrigin(resource);
-			script = Script::Compile(JavascriptContext::GetCurrentIsolate()->GetCurrentContext(), source, origin);
+			bool rejected = compiler_source.GetCachedData()->rejected;
+			JavascriptCodeCache::Consumed(rejected);
+			if (rejected)
+				cached = NULL;
 		}
 
 		if (script.IsEmpty())
 			throw gcnew JavascriptException(tryCatch);
 
+		// Missing or rejected, so (re)generate it.  Only the file writing
+		// happens in the background; serialization needs the isolate.
+		if (cache_key != nullptr && cached == NULL)
+			JavascriptCodeCache::Store(cache_key, ScriptCompiler::CreateCodeCache(script.ToLocalChecked()));
+
 		return script.ToLocalChecked();
 	}
 }
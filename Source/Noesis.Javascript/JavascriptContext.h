@@ -48,6 +48,14 @@ using namespace std;
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class JavascriptExternal;
+ref class JavascriptHeapLimits;
+ref class JavascriptHeapStatistics;
+ref class JavascriptHeapSpaceStatistics;
+ref class JavascriptIsolate;
+ref class JavascriptSnapshot;
+ref class JavascriptScript;
+ref class JavascriptSession;
+ref class CompiledScriptCache;
 
 [System::Flags]
 public enum class SetParameterOptions : int
@@ -58,57 +66,45 @@ public enum class SetParameterOptions : int
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// WrappedMethod
+// WrappedJavascriptExternal
 //
 // Type-safely wraps a native pointer for inclusion in managed code as an IntPtr.  I thought
 // there would already be something for this, but I couldn't find it.
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-public value struct WrappedMethod
+public value struct WrappedJavascriptExternal
 {
 private:
 	System::IntPtr pointer;
 
 internal:
-	WrappedMethod(Persistent<Function> *value)
+	WrappedJavascriptExternal(JavascriptExternal *value)
 	{
 		System::IntPtr value_pointer(value);
-        pointer = value_pointer;
+		pointer = value_pointer;
 	}
 
-	property Persistent<Function> *Pointer
+	property JavascriptExternal *Pointer
     {
-        Persistent<Function> *get()
+        JavascriptExternal *get()
         {
-            return (Persistent<Function> *)(void *)pointer;
+            return (JavascriptExternal *)(void *)pointer;
         }
     }
 };
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-// WrappedJavascriptExternal
+// ReferenceComparer
 //
-// See comment in WrappedMethod.
+// Compares objects by identity, ignoring any Equals() they define, so that
+// distinct .NET objects are never given the same wrapper.
 ////////////////////////////////////////////////////////////////////////////////////////////////////
-public value struct WrappedJavascriptExternal
+ref class ReferenceComparer : System::Collections::Generic::IEqualityComparer<System::Object^>
 {
-private:
-	System::IntPtr pointer;
-
-internal:
-	WrappedJavascriptExternal(JavascriptExternal *value)
-	{
-		System::IntPtr value_pointer(value);
-		pointer = value_pointer;
-	}
+public:
+	virtual bool Equals(System::Object^ x, System::Object^ y) { return System::Object::ReferenceEquals(x, y); }
 
-	property JavascriptExternal *Pointer
-    {
-        JavascriptExternal *get()
-        {
-            return (JavascriptExternal *)(void *)pointer;
-        }
-    }
+	virtual int GetHashCode(System::Object^ obj) { return System::Runtime::CompilerServices::RuntimeHelpers::GetHashCode(obj); }
 };
 
 
@@ -127,10 +123,26 @@ public ref class JavascriptContext: public System::IDisposable
 public:
     static JavascriptContext();
 
+	// Creates a private isolate, which is disposed along with us.  Use
+	// JavascriptIsolate::CreateContext() to share one instead.
 	JavascriptContext();
 
+	// New contexts start from the state captured in the snapshot, rather than
+	// the default one that ships with v8.
+	JavascriptContext(JavascriptSnapshot^ snapshot);
+
+	// Scripts that reach these limits throw JavascriptOutOfMemoryException,
+	// after which the context cannot be used again.
+	JavascriptContext(JavascriptHeapLimits^ heapLimits);
+
+	// Either may be null.
+	JavascriptContext(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits);
+
 	~JavascriptContext();
 
+internal:
+	JavascriptContext(JavascriptIsolate^ iIsolate, bool iOwnsIsolate);
+
 
 	////////////////////////////////////////////////////////////
 	// Public methods
@@ -143,9 +155,61 @@ public:
 
 	System::Object^ GetParameter(System::String^ iName);
 
+	// Converts the value to T, e.g. a JavaScript array of numbers straight
+	// into a double[] or int[] without boxing each element.  Throws
+	// InvalidCastException if the value can't be converted.
+	generic <typename T>
+	T GetParameter(System::String^ iName);
+
+	// Sets the parameter to JSON.parse() of iUtf8Json, without building
+	// .NET objects on the way.  Throws JavascriptException if it is not
+	// valid JSON.
+	void SetParameterJson(System::String^ iName, cli::array<System::Byte>^ iUtf8Json);
+
+	// JSON.stringify() of the parameter, as UTF-8.  Null if there is no
+	// JSON for it, e.g. if it is undefined or a function.
+	cli::array<System::Byte>^ GetParameterJson(System::String^ iName);
+
 	virtual System::Object^ Run(System::String^ iSourceCode);
 
+	// As for GetParameter<T>().
+	generic <typename T>
+	T Run(System::String^ iSourceCode);
+
 	virtual System::Object^ Run(System::String^ iScript, System::String^ iScriptResourceName);
+
+	// Throws JavascriptTimeoutException if the script is still running after
+	// iTimeout.  Timeouts are policed by a single thread shared by all
+	// contexts.
+	System::Object^ Run(System::String^ iScript, System::TimeSpan iTimeout);
+
+	System::Object^ Run(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout);
+
+	// Compiles without running, for scripts that will be run many times.
+	JavascriptScript^ Compile(System::String^ iScript);
+
+	JavascriptScript^ Compile(System::String^ iScript, System::String^ iScriptResourceName);
+
+	// How many distinct scripts passed to Run() are kept compiled.  Zero
+	// turns the cache off.  The cache is shared by all contexts on the
+	// isolate.
+	property int CompiledScriptCacheSize { int get(); void set(int value); }
+
+	property JavascriptIsolate^ Isolate { JavascriptIsolate^ get() { return mIsolate; } }
+
+	// Enters the context once for a batch of calls, rather than once per
+	// call.  Dispose of the session, on the same thread, to leave; a using
+	// block is the only safe way to do that.
+	JavascriptSession^ BeginSession();
+
+	// Both are figures for the whole isolate, not for this context.  v8
+	// can't tell which context memory belongs to, so contexts made by the
+	// same JavascriptIsolate::CreateContext() all report the same numbers,
+	// each including the others' usage.  Isolate->GetHeapStatistics() says
+	// the same thing more plainly.
+	JavascriptHeapStatistics^ GetHeapStatistics();
+
+	cli::array<JavascriptHeapSpaceStatistics^>^ GetHeapSpaceStatistics();
 		
 	property static System::String^ V8Version { System::String^ get(); }
 
@@ -160,6 +224,8 @@ public:
 
     bool IsExecutionTerminating();
 
+	// A full garbage collection of the isolate, which may be shared with
+	// other contexts.  Waits for any script running on it to finish.
 	void Collect();
 
 	// Fatal errors can occur when v8 runs out of memory.  Your process
@@ -179,24 +245,89 @@ public:
 internal:
 	//void SetStackLimit();
 
+	static void EnsureV8Initialised();
+
 	static JavascriptContext^ GetCurrent();
 	
 	static v8::Isolate *GetCurrentIsolate();
 
+	v8::Isolate *GetIsolate() { return isolate; }
+
 	Handle<v8::Object> GetGlobal();
 
     v8::Locker *Enter([System::Runtime::InteropServices::Out] JavascriptContext^% old_context);
 
 	void Exit(v8::Locker *locker, JavascriptContext^ old_context);
 
+	// Unless the result already has a wrapper, the caller must give it one
+	// straight away, with JavascriptExternal::SetWrapper().
 	JavascriptExternal* WrapObject(System::Object^ iObject);
 
+	// Forgets and deletes iExternal, once v8 has collected its wrappers.
+	void ReleaseExternal(JavascriptExternal *iExternal);
+
 	Handle<ObjectTemplate> GetObjectWrapperTemplate();
 
+	// The template for wrapping objects of iType.
+	Handle<ObjectTemplate> GetObjectWrapperTemplate(System::Type^ iType);
+
+	// The function for iType's methods called iName.
+	Handle<Function> GetMethod(System::Type^ iType, System::String^ iName);
+
+	Local<ArrayBuffer> NewPinnedArrayBuffer(System::Array^ iArray);
+
 	void RegisterFunction(System::Object^ f);
 
+	// Called by functions disposed before we are.
+	void UnregisterFunction(System::Object^ f);
+
+	// The bodies of the public methods of the same names, for when the
+	// caller has already entered this context.
+	void SetParameterInScope(System::String^ iName, System::Object^ iObject, SetParameterOptions options);
+
+	System::Object^ GetParameterInScope(System::String^ iName);
+
+	// iResultType may be null, for the default conversion.
+	System::Object^ GetParameterInScope(System::String^ iName, System::Type^ iResultType);
+
+	void SetParameterJsonInScope(System::String^ iName, cli::array<System::Byte>^ iUtf8Json);
+
+	cli::array<System::Byte>^ GetParameterJsonInScope(System::String^ iName);
+
+	// iScriptResourceName may be null.
+	System::Object^ RunInScope(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout);
+
+	System::Object^ RunInScope(System::String^ iScript, System::String^ iScriptResourceName, System::TimeSpan iTimeout, System::Type^ iResultType);
+
+	// Must be called with this context entered.
+	Local<UnboundScript> GetCompiledScript(System::String^ iScript, System::String^ iScriptResourceName);
+
+	// Must be called with this context entered.
+	System::Object^ RunScript(Local<UnboundScript> iScript);
+
+	System::Object^ RunScript(Local<UnboundScript> iScript, System::TimeSpan iTimeout);
+
+	System::Object^ RunScript(Local<UnboundScript> iScript, System::TimeSpan iTimeout, System::Type^ iResultType);
+
+	// Throws away everything the scripts have done, so that the context
+	// can be reused by JavascriptContextPool without paying for a new
+	// isolate.
+	void Reset();
+
+	bool IsDisposed() { return isolate == NULL; }
+
+	// Once the heap limit has been reached, v8 cannot be trusted to do
+	// anything more with our isolate.
+	void ThrowIfOutOfMemory();
+
 	static void FatalErrorCallbackMember(const char* location, const char* message);
 
+private:
+	void Initialise(JavascriptIsolate^ iIsolate, bool iOwnsIsolate);
+
+	// Disposes of everything in mFunctions.
+	void DeleteFunctions();
+
 	////////////////////////////////////////////////////////////
 	// Data members
 	////////////////////////////////////////////////////////////
@@ -209,18 +340,23 @@ protected:
 	// v8 context required to be active for all v8 operations.
 	Persistent<Context>* mContext;
 
-	// Avoids us recreating these too often.
-	Persistent<ObjectTemplate> *objectWrapperTemplate;
+	// Owns the isolate, the templates and the compiled scripts, which may
+	// be shared with other contexts.
+	JavascriptIsolate^ mIsolate;
 
-	// Stores every JavascriptExternal we create.  This saves time if the same
-	// objects are recreated frequently, and stops us building up a huge
-	// collection of JavascriptExternal objects that won't be freed until
-	// the context is destroyed.
+	// True if we created mIsolate just for ourselves.
+	bool mOwnsIsolate;
+
+	// Stores every live JavascriptExternal we create, keyed by identity.
+	// Each has at most one JavaScript wrapper, so the same .NET object is
+	// always the same JavaScript object.  Entries are removed when v8
+	// collects the wrapper.
 	System::Collections::Generic::Dictionary<System::Object ^, WrappedJavascriptExternal> ^mExternals;
 
-	// Stores every JavascriptFunction we create.  Ensures we dispose of them
-	// all.
-	System::Collections::Generic::List<System::Object ^> ^mFunctions;
+	// Stores every JavascriptFunction we create that has not been
+	// disposed.  Ensures we dispose of them all.  Scripts belong to the
+	// isolate instead.
+	System::Collections::Generic::HashSet<System::Object ^> ^mFunctions;
 
 	// See comment for TerminateExecution().
 	bool terminateRuns;
@@ -261,8 +397,17 @@ public:
 // Standalone functions - can be called from unmanaged code too
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void FatalErrorCallback(const char* location, const char* message);
+
 Local<Script> CompileScript(v8::Isolate *isolate, wchar_t const *source_code, wchar_t const *resource_name = NULL);
 
+// Consults and feeds JavascriptCodeCache, if enabled.
+Local<UnboundScript> CompileUnboundScript(v8::Isolate *isolate, wchar_t const *source_code, wchar_t const *resource_name = NULL);
+
+// As above, but large sources are shared with v8 by JavascriptExternalString
+// instead of being copied.
+Local<UnboundScript> CompileUnboundScript(v8::Isolate *isolate, System::String^ source_code, wchar_t const *resource_name = NULL);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } } // namespace Noesis::Javascript
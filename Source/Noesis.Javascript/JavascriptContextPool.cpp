@@ -0,0 +1,187 @@
+#include <msclr\lock.h>
+
+#include "JavascriptContextPool.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptSnapshot.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace msclr;
+using namespace System::Collections::Generic;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptContextPool::JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout)
+{
+	Initialise(minSize, maxSize, idleTimeout, nullptr, nullptr);
+}
+
+JavascriptContextPool::JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot)
+{
+	if (snapshot == nullptr)
+		throw gcnew System::ArgumentNullException("snapshot");
+	Initialise(minSize, maxSize, idleTimeout, snapshot, nullptr);
+}
+
+JavascriptContextPool::JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits)
+{
+	Initialise(minSize, maxSize, idleTimeout, snapshot, heapLimits);
+}
+
+void
+JavascriptContextPool::Initialise(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits)
+{
+	if (minSize < 0)
+		throw gcnew System::ArgumentOutOfRangeException("minSize");
+	if (maxSize < minSize || maxSize < 1)
+		throw gcnew System::ArgumentOutOfRangeException("maxSize");
+	if (idleTimeout <= System::TimeSpan::Zero)
+		throw gcnew System::ArgumentOutOfRangeException("idleTimeout");
+
+	mMinSize = minSize;
+	mMaxSize = maxSize;
+	mIdleTimeout = idleTimeout;
+	mSnapshot = snapshot;
+	mHeapLimits = heapLimits;
+	mIdle = gcnew LinkedList<IdleContext^>();
+
+	for (int i = 0; i < minSize; i++)
+	{
+		IdleContext^ idle = gcnew IdleContext();
+		idle->context = NewContext();
+		idle->releasedAt = System::DateTime::UtcNow;
+		mIdle->AddLast(idle);
+	}
+
+	mTrimTimer = gcnew System::Threading::Timer(gcnew System::Threading::TimerCallback(this, &JavascriptContextPool::Trim), nullptr, idleTimeout, idleTimeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptContextPool::~JavascriptContextPool()
+{
+	List<JavascriptContext^>^ doomed = gcnew List<JavascriptContext^>();
+	{
+		lock l(mIdle);
+		if (mDisposed)
+			return;
+		mDisposed = true;
+		for each (IdleContext^ idle in mIdle)
+			doomed->Add(idle->context);
+		mIdle->Clear();
+	}
+	delete mTrimTimer;
+	for each (JavascriptContext^ context in doomed)
+		delete context;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int
+JavascriptContextPool::IdleCount::get()
+{
+	lock l(mIdle);
+	return mIdle->Count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptContext^
+JavascriptContextPool::Acquire()
+{
+	{
+		lock l(mIdle);
+		if (mDisposed)
+			throw gcnew System::ObjectDisposedException("JavascriptContextPool");
+		if (mIdle->Count > 0)
+		{
+			JavascriptContext^ context = mIdle->Last->Value->context;
+			mIdle->RemoveLast();
+			System::Threading::Interlocked::Increment(mHits);
+			return context;
+		}
+	}
+
+	// Create outside the lock - this is the slow path we are trying to avoid
+	// and there is no point making everyone else wait for it.
+	System::Threading::Interlocked::Increment(mMisses);
+	return NewContext();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptContext^
+JavascriptContextPool::NewContext()
+{
+	return gcnew JavascriptContext(mSnapshot, mHeapLimits);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptContextPool::Release(JavascriptContext^ context)
+{
+	if (context == nullptr)
+		throw gcnew System::ArgumentNullException("context");
+	if (context->IsDisposed())
+		return;
+
+	bool keep;
+	{
+		lock l(mIdle);
+		keep = !mDisposed && mIdle->Count < mMaxSize;
+	}
+	if (context->Isolate->IsOutOfMemory)
+		keep = false;
+	if (!keep)
+	{
+		delete context;
+		return;
+	}
+
+	context->Reset();
+
+	IdleContext^ idle = gcnew IdleContext();
+	idle->context = context;
+	idle->releasedAt = System::DateTime::UtcNow;
+	{
+		lock l(mIdle);
+		// Somebody else may have filled the pool, or disposed it, while we
+		// were resetting.
+		if (!mDisposed && mIdle->Count < mMaxSize)
+		{
+			mIdle->AddLast(idle);
+			return;
+		}
+	}
+	delete context;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptContextPool::Trim(System::Object^ state)
+{
+	List<JavascriptContext^>^ doomed = gcnew List<JavascriptContext^>();
+	{
+		lock l(mIdle);
+		System::DateTime cutoff = System::DateTime::UtcNow - mIdleTimeout;
+		while (mIdle->Count > mMinSize && mIdle->First->Value->releasedAt < cutoff)
+		{
+			doomed->Add(mIdle->First->Value->context);
+			mIdle->RemoveFirst();
+		}
+	}
+	for each (JavascriptContext^ context in doomed)
+		delete context;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
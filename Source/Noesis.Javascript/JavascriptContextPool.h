@@ -0,0 +1,115 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "JavascriptContext.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptContextPool
+//
+// Keeps initialized JavascriptContexts (and therefore isolates) around so
+// that callers who need a fresh global scope per request do not pay for
+// v8::Isolate::New() and Isolate::Dispose() every time.
+//
+// Contexts handed out by Acquire() must be given back with Release(), which
+// resets them: a new v8::Context is created in the same isolate and all
+// wrapped .NET objects and JavascriptFunctions are released.  Nothing a
+// script did while leased is visible to the next lessee.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptContextPool: public System::IDisposable
+{
+	////////////////////////////////////////////////////////////
+	// Constructor
+	////////////////////////////////////////////////////////////
+public:
+
+	// minSize contexts are created immediately and are never trimmed.
+	// At most maxSize idle contexts are retained; extra ones are
+	// disposed when released.  Idle contexts above minSize are disposed
+	// once they have been unused for idleTimeout.
+	JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout);
+
+	// Contexts are created from, and reset to, the given snapshot.
+	JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot);
+
+	// Either may be null.  Contexts whose scripts reach the heap limits are
+	// disposed, rather than returned to the pool, when released.
+	JavascriptContextPool(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits);
+
+	~JavascriptContextPool();
+
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	JavascriptContext^ Acquire();
+
+	void Release(JavascriptContext^ context);
+
+	property int MinSize { int get() { return mMinSize; } }
+
+	property int MaxSize { int get() { return mMaxSize; } }
+
+	property System::TimeSpan IdleTimeout { System::TimeSpan get() { return mIdleTimeout; } }
+
+	// Number of contexts currently waiting to be leased.
+	property int IdleCount { int get(); }
+
+	// Acquire() calls satisfied by an idle context.
+	property long long Hits { long long get() { return System::Threading::Interlocked::Read(mHits); } }
+
+	// Acquire() calls that had to create a new context.
+	property long long Misses { long long get() { return System::Threading::Interlocked::Read(mMisses); } }
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	void Initialise(int minSize, int maxSize, System::TimeSpan idleTimeout, JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits);
+
+	JavascriptContext^ NewContext();
+
+	void Trim(System::Object^ state);
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	ref struct IdleContext
+	{
+		JavascriptContext^ context;
+		System::DateTime releasedAt;
+	};
+
+	int mMinSize, mMaxSize;
+	System::TimeSpan mIdleTimeout;
+
+	// May be null.
+	JavascriptSnapshot^ mSnapshot;
+
+	// May be null.
+	JavascriptHeapLimits^ mHeapLimits;
+
+	// Most recently released last, so that Acquire() hands out warm
+	// contexts and Trim() finds the stale ones at the front.
+	System::Collections::Generic::LinkedList<IdleContext^> ^mIdle;
+
+	System::Threading::Timer ^mTrimTimer;
+
+	bool mDisposed;
+
+	long long mHits, mMisses;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -162,6 +162,21 @@ JavascriptException::GetSystemException(TryCatch& iTryCatch)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+JavascriptOutOfMemoryException::JavascriptOutOfMemoryException(): JavascriptException(L"Heap limit reached")
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptTimeoutException::JavascriptTimeoutException(System::TimeSpan iTimeout, System::TimeSpan iElapsed, System::TimeSpan iCpuTime): JavascriptException(L"Execution timed out")
+{
+	mTimeout = iTimeout;
+	mElapsed = iElapsed;
+	mCpuTime = iCpuTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 } } // namespace Noesis::Javascript
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
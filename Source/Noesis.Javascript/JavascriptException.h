@@ -91,6 +91,49 @@ private:
 	int mStartColumn, mEndColumn;  // on mLine
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptOutOfMemoryException
+//
+// Thrown when a script reaches the isolate's heap limit.  The script is
+// terminated, and the isolate, along with every context on it, refuses to
+// do anything more.  Dispose of it to get the memory back.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptOutOfMemoryException: JavascriptException
+{
+internal:
+
+	JavascriptOutOfMemoryException();
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptTimeoutException
+//
+// Thrown when a Run() or Call() given a timeout is terminated for
+// exceeding it.  The context remains usable.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptTimeoutException: JavascriptException
+{
+internal:
+
+	JavascriptTimeoutException(System::TimeSpan iTimeout, System::TimeSpan iElapsed, System::TimeSpan iCpuTime);
+
+public:
+
+	property System::TimeSpan Timeout { System::TimeSpan get() { return mTimeout; } }
+
+	// Wall clock time from the start of the call until it was stopped.
+	property System::TimeSpan Elapsed { System::TimeSpan get() { return mElapsed; } }
+
+	// Time the calling thread spent on the CPU over the same period.  Much
+	// less than Elapsed means the script was mostly waiting, e.g. on .NET
+	// code or for the isolate lock.
+	property System::TimeSpan CpuTime { System::TimeSpan get() { return mCpuTime; } }
+
+private:
+
+	System::TimeSpan mTimeout, mElapsed, mCpuTime;
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 } } // namespace Noesis::Javascript
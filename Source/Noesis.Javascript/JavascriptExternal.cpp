@@ -31,6 +31,7 @@
 #include "JavascriptContext.h"
 #include "JavascriptInterop.h"
 #include "JavascriptException.h"
+#include "JavascriptNameTable.h"
 #include "SystemInterop.h"
 
 #include <stdio.h>
@@ -48,18 +49,23 @@ using namespace std;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-JavascriptExternal::JavascriptExternal(System::Object^ iObject)
+JavascriptExternal::JavascriptExternal(System::Object^ iObject, JavascriptContext^ iContext)
 {
 	mObjectHandle = System::Runtime::InteropServices::GCHandle::Alloc(iObject);
 	mOptions = SetParameterOptions::None;
-	mMethods = gcnew System::Collections::Generic::Dictionary<System::String ^, WrappedMethod>();
+	mMembers = JavascriptMemberCache::Get(iObject->GetType());
+	mContext = System::Runtime::InteropServices::GCHandle::Alloc(iContext, System::Runtime::InteropServices::GCHandleType::Weak);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 JavascriptExternal::~JavascriptExternal()
 {
+	// Called with the isolate locked, either from JavascriptContext or
+	// from WrapperCollected().
+	mWrapper.Reset();
 	mObjectHandle.Free();
+	mContext.Free();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -72,40 +78,47 @@ JavascriptExternal::GetObject()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Handle<Function>
-JavascriptExternal::GetMethod(wstring iName)
+void
+JavascriptExternal::SetWrapper(Handle<Object> iWrapper)
 {
-	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
-	System::Collections::Generic::Dictionary<System::String ^, WrappedMethod> ^methods = mMethods;
-	System::String^ memberName = gcnew System::String(iName.c_str());
-	WrappedMethod method;
-	if (methods->TryGetValue(memberName, method))
-		return Local<Function>::New(isolate, *(method.Pointer));
-	else
-	{
-		System::Object^ self = mObjectHandle.Target;
-		System::Type^ type = self->GetType();
-		System::String^ memberName = gcnew System::String(iName.c_str());
-		cli::array<System::Object^>^ objectInfo = gcnew cli::array<System::Object^>(2);
-		objectInfo->SetValue(self,0);
-		objectInfo->SetValue(memberName,1);
-
-		// Verification if it a method
-		cli::array<MemberInfo^>^ members = type->GetMember(memberName);
-		if (members->Length > 0 && members[0]->MemberType == MemberTypes::Method)
-		{
-			JavascriptContext^ context = JavascriptContext::GetCurrent();
-			Handle<External> external = External::New(isolate, context->WrapObject(objectInfo));
-			Handle<FunctionTemplate> functionTemplate = FunctionTemplate::New(isolate, JavascriptInterop::Invoker, external);
-			Handle<Function> function = functionTemplate->GetFunction();
+	mWrapper.Reset(JavascriptContext::GetCurrentIsolate(), iWrapper);
+	mWrapper.SetWeak(this, WrapperCollected, WeakCallbackType::kParameter);
+}
 
-			Persistent<Function> *function_ptr = new Persistent<Function>(isolate, function);
-			WrappedMethod wrapped(function_ptr);
-			methods[memberName] = wrapped;
+////////////////////////////////////////////////////////////////////////////////////////////////////
 
-			return function;
-		}
-	}
+Local<Object>
+JavascriptExternal::GetWrapper()
+{
+	return Local<Object>::New(JavascriptContext::GetCurrentIsolate(), mWrapper);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Called by v8 in the middle of a garbage collection, so it must not use
+// v8 beyond resetting the handle.
+void
+JavascriptExternal::WrapperCollected(const WeakCallbackInfo<JavascriptExternal> &iInfo)
+{
+	JavascriptExternal *external = iInfo.GetParameter();
+	external->mWrapper.Reset();
+	// If the context is already unreachable then it is being torn down,
+	// and will delete us along with the rest.
+	JavascriptContext^ context = safe_cast<JavascriptContext^>(external->mContext.Target);
+	if (context != nullptr)
+		context->ReleaseExternal(external);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Handle<Function>
+JavascriptExternal::GetMethod(System::String^ iName)
+{
+	// Verification if it a method.  The function is shared with every
+	// other object of our type, and is told which object it was called on
+	// by 'this'.
+	if (mMembers->GetMember(iName)->IsMethod)
+		return JavascriptContext::GetCurrent()->GetMethod(mObjectHandle.Target->GetType(), iName);
 	
 	// Wasn't an method
 	return  Handle<Function>();
@@ -116,7 +129,7 @@ JavascriptExternal::GetMethod(wstring iName)
 Handle<Function>
 JavascriptExternal::GetMethod(Handle<String> iName)
 {
-	return GetMethod((wchar_t*) *String::Value(JavascriptContext::GetCurrentIsolate(), iName));
+	return GetMethod(JavascriptNameTable::Get(JavascriptContext::GetCurrentIsolate())->GetName(iName));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -124,41 +137,32 @@ JavascriptExternal::GetMethod(Handle<String> iName)
 // Returns false is no such property exists, otherwise check 'result'
 // for an empty value (exception) or the value (including null)
 bool
-JavascriptExternal::GetProperty(wstring iName, Handle<Value> &result)
+JavascriptExternal::GetProperty(System::String^ iName, Handle<Value> &result)
 {
-	System::Object^ self = mObjectHandle.Target;
-	System::Type^ type = self->GetType();
-	PropertyInfo^ propertyInfo = type->GetProperty(gcnew System::String(iName.c_str()));
+	CachedMember^ member = mMembers->GetMember(iName);
+	if (member->Property != nullptr)
+	{
+		result = GetProperty(member);
+		return true;
+	}
+
+	//may have an indexer
+	PropertyInfo^ indexerInfo = mMembers->StringIndexer;
+	if (indexerInfo == nullptr)
+	{
+		return false;
+	}
 
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 	try
 	{
-		if (propertyInfo == nullptr)
-		{
-			//may have an indexer
-			PropertyInfo^ indexerInfo = type->GetProperty("Item", System::Object::typeid, gcnew cli::array<System::Type^> { System::String::typeid });
-			if (indexerInfo == nullptr)
-			{
-				return false;
-			}
-			if (!indexerInfo->CanRead)
-			{
-				result = isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + gcnew System::String(iName.c_str()) + " may not be read."));
-			}
-			else
-			{
-				result = JavascriptInterop::ConvertToV8(indexerInfo->GetValue(self, gcnew cli::array<System::String^> { gcnew System::String(iName.c_str()) }));
-			}
-			return true;
-		}
-
-		if (!propertyInfo->CanRead)
+		if (!indexerInfo->CanRead)
 		{
-			result = isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + gcnew System::String(iName.c_str()) + " may not be read."));
+			result = isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + iName + " may not be read."));
 		}
 		else
 		{
-			result = JavascriptInterop::ConvertToV8(propertyInfo->GetValue(self, nullptr));
+			result = JavascriptInterop::ConvertToV8(indexerInfo->GetValue(mObjectHandle.Target, gcnew cli::array<System::String^> { iName }));
 		}
 	}
 	catch (System::Reflection::TargetInvocationException^ exception)
@@ -174,12 +178,34 @@ JavascriptExternal::GetProperty(wstring iName, Handle<Value> &result)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Returns an empty value if an exception was thrown.
+Handle<Value>
+JavascriptExternal::GetProperty(CachedMember^ iMember)
+{
+	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
+	try
+	{
+		if (!iMember->Property->CanRead)
+			return isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + iMember->Name + " may not be read."));
+		return JavascriptInterop::ConvertToV8(iMember->GetValue(mObjectHandle.Target));
+	}
+	catch (System::Reflection::TargetInvocationException^ exception)
+	{
+		return JavascriptInterop::HandleTargetInvocationException(exception);
+	}
+	catch (System::Exception^ exception)
+	{
+		return isolate->ThrowException(JavascriptInterop::ConvertToV8(exception));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Handle<Value>
 JavascriptExternal::GetProperty(uint32_t iIndex)
 {
 	System::Object^ self = mObjectHandle.Target;
 	System::Type^ type = self->GetType();
-	cli::array<PropertyInfo^>^ propertyInfo = type->GetProperties();
 	int index = iIndex;
 
 	// Check if it an array
@@ -194,13 +220,11 @@ JavascriptExternal::GetProperty(uint32_t iIndex)
 	{
 		try
 		{
-			cli::array<int^>^ args = gcnew cli::array<int^>(1);
-			args[0] = index;
-			System::Reflection::PropertyInfo^ item_info = type->GetProperty("Item", gcnew cli::array<System::Type^> { int::typeid });
-			if (item_info == nullptr || item_info->GetIndexParameters()->Length != 1)
+			System::Reflection::PropertyInfo^ item_info = mMembers->IntegerIndexer;
+			if (item_info == nullptr)
 				// No indexed property.
 				return Handle<Value>();  // v8 will return null
-			System::Object^ object = type->InvokeMember("Item", System::Reflection::BindingFlags::GetProperty, nullptr, self, args,  nullptr);
+			System::Object^ object = item_info->GetValue(self, gcnew cli::array<System::Object^> { index });
 			return JavascriptInterop::ConvertToV8(object);
 		}
 		catch(System::Reflection::TargetInvocationException^ exception)
@@ -220,37 +244,54 @@ JavascriptExternal::GetProperty(uint32_t iIndex)
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Handle<Value>
-JavascriptExternal::SetProperty(wstring iName, Handle<Value> iValue)
+JavascriptExternal::SetProperty(System::String^ iName, Handle<Value> iValue)
 {
-	System::Object^ self = mObjectHandle.Target;
-	System::Type^ type = self->GetType();
-	PropertyInfo^ propertyInfo = type->GetProperty(gcnew System::String(iName.c_str()));
+	CachedMember^ member = mMembers->GetMember(iName);
+	if (member->Property != nullptr)
+		return SetProperty(member, iValue);
 
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 
 	try
 	{
-		if (propertyInfo == nullptr)
+		//may have an indexer
+		PropertyInfo^ indexerInfo = mMembers->StringIndexer;
+		if (indexerInfo == nullptr)
 		{
-			//may have an indexer
-			PropertyInfo^ indexerInfo = type->GetProperty("Item", System::Object::typeid, gcnew cli::array<System::Type^> { System::String::typeid });
-			if (indexerInfo == nullptr)
-			{
-				if ((mOptions & SetParameterOptions::RejectUnknownProperties) == SetParameterOptions::RejectUnknownProperties)
-					return isolate->ThrowException(JavascriptInterop::ConvertToV8("Unknown member: " + gcnew System::String(iName.c_str())));
-				return Handle<Value>();
-			}
-			if (!indexerInfo->CanWrite)
-			{
-				return isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + gcnew System::String(iName.c_str()) + " may not be set."));
-			}
-			else
-			{
-				indexerInfo->SetValue(self, JavascriptInterop::ConvertFromV8(iValue), gcnew cli::array<System::String^> { gcnew System::String(iName.c_str()) });
-			}
-			return iValue;
+			if ((mOptions & SetParameterOptions::RejectUnknownProperties) == SetParameterOptions::RejectUnknownProperties)
+				return isolate->ThrowException(JavascriptInterop::ConvertToV8("Unknown member: " + iName));
+			return Handle<Value>();
+		}
+		if (!indexerInfo->CanWrite)
+		{
+			return isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + iName + " may not be set."));
+		}
+		else
+		{
+			indexerInfo->SetValue(mObjectHandle.Target, JavascriptInterop::ConvertFromV8(iValue), gcnew cli::array<System::String^> { iName });
 		}
+		return iValue;
+	}
+	catch (System::Reflection::TargetInvocationException^ exception)
+	{
+		return JavascriptInterop::HandleTargetInvocationException(exception);
+	}
+	catch (System::Exception^ exception)
+	{
+		return isolate->ThrowException(JavascriptInterop::ConvertToV8(exception));
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Handle<Value>
+JavascriptExternal::SetProperty(CachedMember^ iMember, Handle<Value> iValue)
+{
+	PropertyInfo^ propertyInfo = iMember->Property;
+	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 
+	try
+	{
 		System::Object^ value = JavascriptInterop::ConvertFromV8(iValue);
 		if (value != nullptr) {
 			System::Type^ valueType = value->GetType();
@@ -263,11 +304,11 @@ JavascriptExternal::SetProperty(wstring iName, Handle<Value> iValue)
 
 		if (!propertyInfo->CanWrite)
 		{
-			return isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + gcnew System::String(iName.c_str()) + " may not be set."));
+			return isolate->ThrowException(JavascriptInterop::ConvertToV8("Property " + iMember->Name + " may not be set."));
 		}
 		else
 		{
-			propertyInfo->SetValue(self, value, nullptr);
+			iMember->SetValue(mObjectHandle.Target, value);
 			// We used to convert and return propertyInfo->GetValue() here.
 			// I don't know why we did, but I stopped it because CanRead
 			// might be false, which should not stop us _setting_.
@@ -294,7 +335,6 @@ JavascriptExternal::SetProperty(uint32_t iIndex, Handle<Value> iValue)
 {
 	System::Object^ self = mObjectHandle.Target;
 	System::Type^ type = self->GetType();
-	cli::array<PropertyInfo^>^ propertyInfo = type->GetProperties();
 	int index = iIndex;
 
 	// Check if it an array or an indexer
@@ -309,8 +349,8 @@ JavascriptExternal::SetProperty(uint32_t iIndex, Handle<Value> iValue)
 		v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
 		try
 		{
-			System::Reflection::PropertyInfo^ item_info = type->GetProperty("Item", gcnew cli::array<System::Type^> { int::typeid });
-			if (item_info == nullptr || item_info->GetIndexParameters()->Length != 1) {
+			System::Reflection::PropertyInfo^ item_info = mMembers->IntegerIndexer;
+			if (item_info == nullptr) {
 				return isolate->ThrowException(JavascriptInterop::ConvertToV8("No public integer-indexed property."));
 			} else {
 				cli::array<System::Object^>^ index_args = gcnew cli::array<System::Object^>(1);
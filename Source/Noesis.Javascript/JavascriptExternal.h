@@ -34,6 +34,7 @@
 #include <map>
 #include <gcroot.h>
 #include "JavascriptContext.h"
+#include "JavascriptMemberCache.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -49,6 +50,10 @@ namespace Noesis { namespace Javascript {
 //
 // Wraps around a CLI object and serves it up to v8.  This object is itself
 // stored within the 0th internal field of a JavaScript object.
+//
+// Each CLI object has one JavaScript wrapper per context, which we hold
+// weakly.  Once v8 has collected it we are removed from the context and
+// deleted, which lets go of the CLI object.
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 class JavascriptExternal
 {
@@ -57,7 +62,7 @@ class JavascriptExternal
 	////////////////////////////////////////////////////////////
 public:
 
-	JavascriptExternal(System::Object^ iObject);
+	JavascriptExternal(System::Object^ iObject, JavascriptContext^ iContext);
 
 	~JavascriptExternal();
 
@@ -73,18 +78,40 @@ public:
 
 	System::Object^ GetObject();
 
-	Handle<Function> GetMethod(wstring iName);
+	JavascriptMemberCache^ GetMembers() { return mMembers; }
+
+	Handle<Function> GetMethod(System::String^ iName);
 
 	Handle<Function> GetMethod(Handle<String> iName);
 
-	bool GetProperty(wstring iName, Handle<Value> &result);
+	bool GetProperty(System::String^ iName, Handle<Value> &result);
+
+	// iMember must be a property.
+	Handle<Value> GetProperty(CachedMember^ iMember);
 
 	Handle<Value> GetProperty(uint32_t iIndex);
 
-	Handle<Value> SetProperty(wstring iName, Handle<Value> iValue);
+	Handle<Value> SetProperty(System::String^ iName, Handle<Value> iValue);
+
+	// iMember must be a property.
+	Handle<Value> SetProperty(CachedMember^ iMember, Handle<Value> iValue);
 
 	Handle<Value> SetProperty(uint32_t iIndex, Handle<Value> iValue);
 
+	// Keeps us alive for as long as iWrapper, which must refer to us.  Must
+	// be called once, before anything else can trigger a garbage collection.
+	void SetWrapper(Handle<Object> iWrapper);
+
+	// The object passed to SetWrapper(), or an empty handle before then.
+	Local<Object> GetWrapper();
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	static void WrapperCollected(const WeakCallbackInfo<JavascriptExternal> &iInfo);
+
 	////////////////////////////////////////////////////////////
 	// Data members
 	////////////////////////////////////////////////////////////
@@ -96,8 +123,15 @@ private:
 
 	SetParameterOptions mOptions;
 
-	// Owned by JavascriptContext.
-	gcroot<System::Collections::Generic::Dictionary<System::String ^, WrappedMethod> ^> mMethods;
+	// Shared with every other wrapper of the same type.
+	gcroot<JavascriptMemberCache ^> mMembers;
+
+	// Weak handle to the context that created us, and will delete us.
+	// Weak so that we don't keep an abandoned context from being finalized.
+	System::Runtime::InteropServices::GCHandle mContext;
+
+	// Weak handle to the JavaScript object that refers to us.
+	Persistent<Object> mWrapper;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,133 @@
+#include <msclr\lock.h>
+#include <vcclr.h>
+
+#include "JavascriptExternalString.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace msclr;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SharedString
+{
+	const uint16_t *data;
+	size_t length;
+	void *handle;  // the pinning GCHandle
+	int references;  // guarded by sShared
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// SharedStringResource
+//
+// One per v8 string, because v8 disposes each resource once.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class SharedStringResource : public v8::String::ExternalStringResource
+{
+public:
+
+	SharedStringResource(SharedString *iShared) : mShared(iShared) {}
+
+	virtual const uint16_t *data() const;
+
+	virtual size_t length() const;
+
+protected:
+
+	virtual void Dispose();
+
+private:
+
+	SharedString *mShared;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+
+// v8 may ask for these often, so keep them native.
+const uint16_t *
+SharedStringResource::data() const
+{
+	return mShared->data;
+}
+
+size_t
+SharedStringResource::length() const
+{
+	return mShared->length;
+}
+
+#pragma managed(pop)
+
+void
+SharedStringResource::Dispose()
+{
+	JavascriptExternalString::Release(mShared);
+	delete this;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+v8::Local<v8::String>
+JavascriptExternalString::New(v8::Isolate *iIsolate, System::String^ iString)
+{
+	if (iString->Length < MinimumLength)
+		return v8::Local<v8::String>();
+
+	SharedString *shared;
+	{
+		lock l(sShared);
+		System::IntPtr pointer;
+		if (sShared->TryGetValue(iString, pointer))
+		{
+			shared = (SharedString *)pointer.ToPointer();
+		}
+		else
+		{
+			System::Runtime::InteropServices::GCHandle handle = System::Runtime::InteropServices::GCHandle::Alloc(iString, System::Runtime::InteropServices::GCHandleType::Pinned);
+			shared = new SharedString();
+			shared->data = (const uint16_t *)handle.AddrOfPinnedObject().ToPointer();
+			shared->length = iString->Length;
+			shared->handle = System::Runtime::InteropServices::GCHandle::ToIntPtr(handle).ToPointer();
+			shared->references = 0;
+			sShared->Add(iString, System::IntPtr(shared));
+		}
+		shared->references++;
+	}
+
+	SharedStringResource *resource = new SharedStringResource(shared);
+	v8::Local<v8::String> result;
+	if (!v8::String::NewExternalTwoByte(iIsolate, resource).ToLocal(&result))
+	{
+		// v8 doesn't take ownership when it fails.
+		Release(shared);
+		delete resource;
+		return v8::Local<v8::String>();
+	}
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptExternalString::Release(SharedString *iShared)
+{
+	lock l(sShared);
+	if (--iShared->references > 0)
+		return;
+	System::Runtime::InteropServices::GCHandle handle = System::Runtime::InteropServices::GCHandle::FromIntPtr(System::IntPtr(iShared->handle));
+	sShared->Remove(handle.Target);
+	handle.Free();
+	delete iShared;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
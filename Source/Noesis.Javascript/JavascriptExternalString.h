@@ -0,0 +1,51 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+#include "JavascriptContext.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct SharedString;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptExternalString
+//
+// Lets v8 read the characters of large .NET strings in place, instead of
+// copying them into the heap of every isolate they are passed to.  The
+// .NET string stays pinned while any v8 string made from it is alive, in
+// any isolate; each v8 string holds one reference, which v8 drops when it
+// collects the string or disposes the isolate.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class JavascriptExternalString abstract sealed
+{
+internal:
+
+	// Shorter strings are cheaper to copy than to share.
+	literal int MinimumLength = 64 * 1024;
+
+	// Returns an empty handle if iString is shorter than MinimumLength.
+	static v8::Local<v8::String> New(v8::Isolate *iIsolate, System::String^ iString);
+
+	// Drops a reference taken by New().  Called by v8, on any isolate's
+	// thread.
+	static void Release(SharedString *iShared);
+
+private:
+
+	// SharedString* for each pinned string, keyed by identity.  Also the
+	// lock for the reference counts.
+	static System::Collections::Generic::Dictionary<System::Object^, System::IntPtr> ^sShared = gcnew System::Collections::Generic::Dictionary<System::Object^, System::IntPtr>(gcnew ReferenceComparer());
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2,6 +2,7 @@
 #include "JavascriptInterop.h"
 #include "JavascriptContext.h"
 #include "JavascriptException.h"
+#include "JavascriptWatchdog.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +34,8 @@ JavascriptFunction::~JavascriptFunction()
 		{
 			JavascriptScope scope(mContext);
 			mFuncHandle->Reset();
+			if (!mContext->IsDisposed())
+				mContext->UnregisterFunction(this);
 		}
 		delete mFuncHandle;
 		mFuncHandle = nullptr;
@@ -41,7 +44,20 @@ JavascriptFunction::~JavascriptFunction()
 
 System::Object^ JavascriptFunction::Call(... cli::array<System::Object^>^ args)
 {
+	return Call(System::Threading::Timeout::InfiniteTimeSpan, args);
+}
+
+System::Object^ JavascriptFunction::Call(System::TimeSpan timeout, cli::array<System::Object^>^ args)
+{
+	if (args == nullptr)
+		throw gcnew System::ArgumentNullException("args");
 	JavascriptScope scope(mContext);
+	return CallInScope(timeout, args);
+}
+
+System::Object^ JavascriptFunction::CallInScope(System::TimeSpan timeout, cli::array<System::Object^>^ args)
+{
+	mContext->ThrowIfOutOfMemory();
 	v8::Isolate* isolate = mContext->GetCurrentIsolate();
 	HandleScope handleScope(isolate);
 
@@ -55,9 +71,14 @@ System::Object^ JavascriptFunction::Call(... cli::array<System::Object^>^ args)
 	}
 
 	TryCatch tryCatch(isolate);
+	JavascriptTimeout callTimeout(isolate, timeout);
 	Local<Value> retVal = mFuncHandle->Get(isolate)->Call(global, argc, argv);
+	callTimeout.Stop(!retVal.IsEmpty());
 	if (retVal.IsEmpty())
+	{
+		mContext->ThrowIfOutOfMemory();
 		throw gcnew JavascriptException(tryCatch);
+	}
 
 	delete [] argv;
 	return JavascriptInterop::ConvertFromV8(retVal);
@@ -27,6 +27,18 @@ public:
 
 	System::Object^ Call(... cli::array<System::Object^>^ args);
 
+	// Throws JavascriptTimeoutException if the function is still running
+	// after timeout.
+	System::Object^ Call(System::TimeSpan timeout, cli::array<System::Object^>^ args);
+
+internal:
+	JavascriptContext^ GetContext() { return mContext; }
+
+	// For callers that have already entered our context.
+	System::Object^ CallInScope(System::TimeSpan timeout, cli::array<System::Object^>^ args);
+
+public:
+
 	static bool operator== (JavascriptFunction^ func1, JavascriptFunction^ func2);
 	bool Equals(JavascriptFunction^ other);
 	
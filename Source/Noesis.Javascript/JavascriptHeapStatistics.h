@@ -0,0 +1,201 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptHeapStatistics
+//
+// A snapshot of v8::HeapStatistics for one isolate, or a sum over several.
+// All sizes are in bytes.  Nothing is broken down by context: contexts that
+// share an isolate share its figures.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptHeapStatistics
+{
+public:
+	property long long TotalHeapSize {
+		public: long long get() { return mTotalHeapSize; }
+		internal: void set(long long value) { mTotalHeapSize = value; }
+	}
+
+	property long long TotalHeapSizeExecutable {
+		public: long long get() { return mTotalHeapSizeExecutable; }
+		internal: void set(long long value) { mTotalHeapSizeExecutable = value; }
+	}
+
+	property long long TotalPhysicalSize {
+		public: long long get() { return mTotalPhysicalSize; }
+		internal: void set(long long value) { mTotalPhysicalSize = value; }
+	}
+
+	property long long TotalAvailableSize {
+		public: long long get() { return mTotalAvailableSize; }
+		internal: void set(long long value) { mTotalAvailableSize = value; }
+	}
+
+	property long long UsedHeapSize {
+		public: long long get() { return mUsedHeapSize; }
+		internal: void set(long long value) { mUsedHeapSize = value; }
+	}
+
+	property long long HeapSizeLimit {
+		public: long long get() { return mHeapSizeLimit; }
+		internal: void set(long long value) { mHeapSizeLimit = value; }
+	}
+
+	property long long MallocedMemory {
+		public: long long get() { return mMallocedMemory; }
+		internal: void set(long long value) { mMallocedMemory = value; }
+	}
+
+	property long long PeakMallocedMemory {
+		public: long long get() { return mPeakMallocedMemory; }
+		internal: void set(long long value) { mPeakMallocedMemory = value; }
+	}
+
+	// Memory outside the v8 heap that v8 has been told about, such as
+	// ArrayBuffer contents.
+	property long long ExternalMemory {
+		public: long long get() { return mExternalMemory; }
+		internal: void set(long long value) { mExternalMemory = value; }
+	}
+
+	// ArrayBuffer contents allocated by scripts, as counted by our own
+	// allocator.  It has one count per isolate, whichever of its contexts
+	// the scripts ran in.
+	property long long ArrayBufferMemory {
+		public: long long get() { return mArrayBufferMemory; }
+		internal: void set(long long value) { mArrayBufferMemory = value; }
+	}
+
+	property long long PeakArrayBufferMemory {
+		public: long long get() { return mPeakArrayBufferMemory; }
+		internal: void set(long long value) { mPeakArrayBufferMemory = value; }
+	}
+
+	property long long ArrayBufferAllocations {
+		public: long long get() { return mArrayBufferAllocations; }
+		internal: void set(long long value) { mArrayBufferAllocations = value; }
+	}
+
+	// Allocations refused by JavascriptHeapLimits::MaxArrayBufferMemoryMB.
+	property long long FailedArrayBufferAllocations {
+		public: long long get() { return mFailedArrayBufferAllocations; }
+		internal: void set(long long value) { mFailedArrayBufferAllocations = value; }
+	}
+
+	property int NumberOfNativeContexts {
+		public: int get() { return mNumberOfNativeContexts; }
+		internal: void set(int value) { mNumberOfNativeContexts = value; }
+	}
+
+	// Contexts that have been disposed but not yet garbage collected.  A
+	// number that keeps growing points to a leak.
+	property int NumberOfDetachedContexts {
+		public: int get() { return mNumberOfDetachedContexts; }
+		internal: void set(int value) { mNumberOfDetachedContexts = value; }
+	}
+
+	// One, unless this is a sum.
+	property int NumberOfIsolates {
+		public: int get() { return mNumberOfIsolates; }
+		internal: void set(int value) { mNumberOfIsolates = value; }
+	}
+
+	// When the figures were taken.  For a sum, the oldest of them.
+	property System::DateTime SampledAt {
+		public: System::DateTime get() { return mSampledAt; }
+		internal: void set(System::DateTime value) { mSampledAt = value; }
+	}
+
+internal:
+	void Add(JavascriptHeapStatistics^ other)
+	{
+		mTotalHeapSize += other->mTotalHeapSize;
+		mTotalHeapSizeExecutable += other->mTotalHeapSizeExecutable;
+		mTotalPhysicalSize += other->mTotalPhysicalSize;
+		mTotalAvailableSize += other->mTotalAvailableSize;
+		mUsedHeapSize += other->mUsedHeapSize;
+		mHeapSizeLimit += other->mHeapSizeLimit;
+		mMallocedMemory += other->mMallocedMemory;
+		mPeakMallocedMemory += other->mPeakMallocedMemory;
+		mExternalMemory += other->mExternalMemory;
+		mArrayBufferMemory += other->mArrayBufferMemory;
+		mPeakArrayBufferMemory += other->mPeakArrayBufferMemory;
+		mArrayBufferAllocations += other->mArrayBufferAllocations;
+		mFailedArrayBufferAllocations += other->mFailedArrayBufferAllocations;
+		mNumberOfNativeContexts += other->mNumberOfNativeContexts;
+		mNumberOfDetachedContexts += other->mNumberOfDetachedContexts;
+		mNumberOfIsolates += other->mNumberOfIsolates;
+		if (other->mSampledAt < mSampledAt)
+			mSampledAt = other->mSampledAt;
+	}
+
+private:
+	long long mTotalHeapSize;
+	long long mTotalHeapSizeExecutable;
+	long long mTotalPhysicalSize;
+	long long mTotalAvailableSize;
+	long long mUsedHeapSize;
+	long long mHeapSizeLimit;
+	long long mMallocedMemory;
+	long long mPeakMallocedMemory;
+	long long mExternalMemory;
+	long long mArrayBufferMemory;
+	long long mPeakArrayBufferMemory;
+	long long mArrayBufferAllocations;
+	long long mFailedArrayBufferAllocations;
+	int mNumberOfNativeContexts;
+	int mNumberOfDetachedContexts;
+	int mNumberOfIsolates;
+	System::DateTime mSampledAt;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptHeapSpaceStatistics
+//
+// v8::HeapSpaceStatistics for one space (new space, old space, code space
+// and so on) of one isolate.  All sizes are in bytes.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptHeapSpaceStatistics
+{
+public:
+	property System::String^ SpaceName {
+		public: System::String^ get() { return mSpaceName; }
+		internal: void set(System::String^ value) { mSpaceName = value; }
+	}
+
+	property long long SpaceSize {
+		public: long long get() { return mSpaceSize; }
+		internal: void set(long long value) { mSpaceSize = value; }
+	}
+
+	property long long SpaceUsedSize {
+		public: long long get() { return mSpaceUsedSize; }
+		internal: void set(long long value) { mSpaceUsedSize = value; }
+	}
+
+	property long long SpaceAvailableSize {
+		public: long long get() { return mSpaceAvailableSize; }
+		internal: void set(long long value) { mSpaceAvailableSize = value; }
+	}
+
+	property long long PhysicalSpaceSize {
+		public: long long get() { return mPhysicalSpaceSize; }
+		internal: void set(long long value) { mPhysicalSpaceSize = value; }
+	}
+
+private:
+	System::String^ mSpaceName;
+	long long mSpaceSize;
+	long long mSpaceUsedSize;
+	long long mSpaceAvailableSize;
+	long long mPhysicalSpaceSize;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -33,8 +33,14 @@
 #include "SystemInterop.h"
 #include "JavascriptException.h"
 #include "JavascriptExternal.h"
+#include "JavascriptExternalString.h"
 #include "JavascriptFunction.h"
+#include "JavascriptIsolate.h"
+#include "JavascriptLatin1.h"
+#include "JavascriptMemberCache.h"
+#include "JavascriptNameTable.h"
 
+#include <memory>
 #include <string>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -49,17 +55,72 @@ using namespace System::Collections::Generic;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Handle<ObjectTemplate>
+Handle<FunctionTemplate>
 JavascriptInterop::NewObjectWrapperTemplate()
 {
-	Handle<ObjectTemplate> result = ObjectTemplate::New(JavascriptContext::GetCurrentIsolate());
-	result->SetInternalFieldCount(1);
+	Handle<FunctionTemplate> result = FunctionTemplate::New(JavascriptContext::GetCurrentIsolate());
+	Handle<ObjectTemplate> instance = result->InstanceTemplate();
+	instance->SetInternalFieldCount(1);
 
     NamedPropertyHandlerConfiguration namedPropertyConfig((GenericNamedPropertyGetterCallback) Getter, (GenericNamedPropertySetterCallback) Setter, nullptr, nullptr, nullptr, Local<Value>(), PropertyHandlerFlags::kOnlyInterceptStrings);
-	result->SetHandler(namedPropertyConfig);
+	instance->SetHandler(namedPropertyConfig);
 
     IndexedPropertyHandlerConfiguration indexedPropertyConfig((IndexedPropertyGetterCallback) IndexGetter, (IndexedPropertySetterCallback) IndexSetter);
-    result->SetHandler(indexedPropertyConfig);
+    instance->SetHandler(indexedPropertyConfig);
+
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Gives v8 real accessors and prototype methods for the type's members, so
+// that objects of the type share a hidden class and v8 can cache lookups
+// on them.  The interceptors only see names that aren't members.
+//
+// Types indexed by string can have any property at all, so they keep the
+// generic template, which intercepts everything.
+Handle<FunctionTemplate>
+JavascriptInterop::NewObjectWrapperTemplate(System::Type^ iType)
+{
+	JavascriptMemberCache^ members = JavascriptMemberCache::Get(iType);
+	if (members->StringIndexer != nullptr || System::Dynamic::IDynamicMetaObjectProvider::typeid->IsAssignableFrom(iType))
+		return Handle<FunctionTemplate>();
+
+	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
+	Handle<FunctionTemplate> result = FunctionTemplate::New(isolate);
+	result->SetClassName(Local<String>::Cast(ConvertToV8(iType->Name)));
+	Handle<ObjectTemplate> instance = result->InstanceTemplate();
+	instance->SetInternalFieldCount(1);
+
+	// Enumerable, so that Object.keys() lists them.
+	cli::array<CachedMember^>^ properties = members->Properties;
+	for (int i = 0; i < properties->Length; i++)
+		instance->SetAccessor(Local<String>::Cast(ConvertToV8(properties[i]->Name)), PropertyGetter, PropertySetter, v8::Integer::New(isolate, i));
+
+	// Methods are called with the wrapper as 'this', which the signature
+	// enforces.  They are not enumerable, as on built-in prototypes, so
+	// that for-in only sees the properties.
+	Handle<Signature> signature = Signature::New(isolate, result);
+	Handle<ObjectTemplate> prototype = result->PrototypeTemplate();
+	cli::array<System::String^>^ methods = members->Methods;
+	for (int i = 0; i < methods->Length; i++)
+		prototype->Set(Local<String>::Cast(ConvertToV8(methods[i])), FunctionTemplate::New(isolate, PrototypeInvoker, v8::Integer::New(isolate, i), signature), v8::DontEnum);
+
+	// map toString with ToString, unless the type has its own
+	CachedMember^ toString = members->GetMember("toString");
+	if (!toString->IsMethod && toString->Property == nullptr)
+	{
+		int index = System::Array::IndexOf(methods, "ToString");
+		if (index >= 0)
+			prototype->Set(v8::String::NewFromUtf8(isolate, "toString", v8::NewStringType::kNormal).ToLocalChecked(), FunctionTemplate::New(isolate, PrototypeInvoker, v8::Integer::New(isolate, index), signature), v8::DontEnum);
+	}
+
+	NamedPropertyHandlerConfiguration namedPropertyConfig((GenericNamedPropertyGetterCallback) Getter, (GenericNamedPropertySetterCallback) Setter, nullptr, nullptr, nullptr, Local<Value>(),
+		(PropertyHandlerFlags)((int)PropertyHandlerFlags::kOnlyInterceptStrings | (int)PropertyHandlerFlags::kNonMasking));
+	instance->SetHandler(namedPropertyConfig);
+
+	IndexedPropertyHandlerConfiguration indexedPropertyConfig((IndexedPropertyGetterCallback) IndexGetter, (IndexedPropertySetterCallback) IndexSetter);
+	instance->SetHandler(indexedPropertyConfig);
 
 	return result;
 }
@@ -118,6 +179,41 @@ JavascriptInterop::ConvertFromV8(Handle<Value> iValue)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+System::Object^
+JavascriptInterop::ConvertFromV8(Handle<Value> iValue, System::Type^ iType)
+{
+	if (iType->IsArray && iValue->IsArray())
+	{
+		System::Array^ numbers = ConvertNumberArrayFromV8(Handle<v8::Array>::Cast(iValue), iType->GetElementType());
+		if (numbers != nullptr)
+			return numbers;
+	}
+
+	System::Object^ value = ConvertFromV8(iValue);
+	if (value == nullptr)
+	{
+		// Otherwise the caller's safe_cast would throw NullReferenceException.
+		if (iType->IsValueType && System::Nullable::GetUnderlyingType(iType) == nullptr)
+			throw gcnew System::InvalidCastException("Cannot convert null to " + iType->FullName + ".");
+		return nullptr;
+	}
+
+	// Stricter than ConvertToType(), which method calls rely on to turn
+	// anything into an int.
+	System::Type^ target = System::Nullable::GetUnderlyingType(iType);
+	if (target == nullptr)
+		target = iType;
+	if (SystemInterop::IsIntegerType(target) && value->GetType() != target)
+		return SystemInterop::ConvertToInteger(value, target);
+
+	System::Object^ converted = SystemInterop::ConvertToType(value, iType);
+	if (converted == nullptr)
+		throw gcnew System::InvalidCastException("Cannot convert " + value->GetType()->FullName + " to " + iType->FullName + ".");
+	return converted;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 System::Object^
 JavascriptInterop::ConvertFromV8(Handle<Value> iValue, ConvertedObjects &already_converted)
 {
@@ -130,9 +226,11 @@ JavascriptInterop::ConvertFromV8(Handle<Value> iValue, ConvertedObjects &already
 	if (iValue->IsNumber())
 		return gcnew System::Double(iValue->NumberValue(JavascriptContext::GetCurrentIsolate()->GetCurrentContext()).ToChecked());
 	if (iValue->IsString())
-		return gcnew System::String((wchar_t*)*String::Value(JavascriptContext::GetCurrentIsolate(), iValue->ToString(JavascriptContext::GetCurrentIsolate())));
+		return ConvertStringFromV8(JavascriptContext::GetCurrentIsolate(), Handle<String>::Cast(iValue));
 	if (iValue->IsArray())
 		return ConvertArrayFromV8(iValue, already_converted);
+	if (iValue->IsArrayBufferView() || iValue->IsArrayBuffer())
+		return ConvertTypedArrayFromV8(iValue);
 	if (iValue->IsDate())
 		return ConvertDateFromV8(iValue);
     if (iValue->IsRegExp())
@@ -158,88 +256,64 @@ Handle<Value>
 JavascriptInterop::ConvertToV8(System::Object^ iObject)
 {
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
-	if (iObject != nullptr)
-	{
-		System::Type^ type = iObject->GetType();
+	if (iObject == nullptr)
+		return Null(isolate);
 
-		if (type->IsValueType)
-		{
-			// Common types first.
-			if (type == System::Int32::typeid)
-				return v8::Int32::New(isolate, safe_cast<int>(iObject));
-			if (type == System::Double::typeid)
-				return v8::Number::New(isolate, safe_cast<double>(iObject));
-			if (type == System::Boolean::typeid)
-				return v8::Boolean::New(isolate, safe_cast<bool>(iObject));
-			if (type->IsEnum)
-			{
-				// No equivalent to enum, so convert to a string.
-				pin_ptr<const wchar_t> valuePtr = PtrToStringChars(iObject->ToString());
-				wchar_t* value = (wchar_t*) valuePtr;
-				return v8::String::NewFromTwoByte(isolate, (uint16_t*)value, v8::NewStringType::kNormal).ToLocalChecked();
-			}
-			else
-			{
-				if (type == System::Char::typeid)
-				{
-					uint16_t c = (uint16_t)safe_cast<wchar_t>(iObject);
-					return v8::String::NewFromTwoByte(isolate, &c, v8::NewStringType::kNormal, 1).ToLocalChecked();
-				}
-				if (type == System::Int64::typeid)
-					return v8::Number::New(isolate, (double)safe_cast<long long>(iObject));
-				if (type == System::Int16::typeid)
-					return v8::Int32::New(isolate, safe_cast<short>(iObject));
-				if (type == System::SByte::typeid)
-					return v8::Int32::New(isolate, safe_cast<signed char>(iObject));
-				if (type == System::Byte::typeid)
-					return v8::Int32::New(isolate, safe_cast<unsigned char>(iObject));
-				if (type == System::UInt16::typeid)
-					return v8::Uint32::New(isolate, safe_cast<unsigned short>(iObject));
-				if (type == System::UInt32::typeid)
-					return v8::Number::New(isolate, safe_cast<unsigned int>(iObject));  // I tried v8::Uint32, but it converted MaxInt to -1.
-				if (type == System::UInt64::typeid)
-					return v8::Number::New(isolate, (double)safe_cast<unsigned long long>(iObject));
-				if (type == System::Single::typeid)
-					return v8::Number::New(isolate, safe_cast<float>(iObject));
-				if (type == System::Decimal::typeid)
-					return v8::Number::New(isolate, (double)safe_cast<System::Decimal>(iObject));
-				if (type == System::DateTime::typeid)
-					return v8::Date::New(isolate->GetCurrentContext(), SystemInterop::ConvertFromSystemDateTime(safe_cast<System::DateTime^>(iObject))).ToLocalChecked();
-			}
-		}
-		if (type == System::String::typeid)
+	switch (ConverterCache::GetKind(iObject->GetType()))
+	{
+	case ConverterKind::Int32:
+		return v8::Int32::New(isolate, safe_cast<int>(iObject));
+	case ConverterKind::Double:
+		return v8::Number::New(isolate, safe_cast<double>(iObject));
+	case ConverterKind::Boolean:
+		return v8::Boolean::New(isolate, safe_cast<bool>(iObject));
+	case ConverterKind::Enum:
 		{
-			pin_ptr<const wchar_t> valuePtr = PtrToStringChars(safe_cast<System::String^>(iObject));
+			// No equivalent to enum, so convert to a string.
+			pin_ptr<const wchar_t> valuePtr = PtrToStringChars(iObject->ToString());
 			wchar_t* value = (wchar_t*) valuePtr;
 			return v8::String::NewFromTwoByte(isolate, (uint16_t*)value, v8::NewStringType::kNormal).ToLocalChecked();
 		}
-		if (type->IsArray)
-			return ConvertFromSystemArray(safe_cast<System::Array^>(iObject));
-        if (type == System::Text::RegularExpressions::Regex::typeid)
-            return ConvertFromSystemRegex(safe_cast<System::Text::RegularExpressions::Regex^>(iObject));
-		if (System::Delegate::typeid->IsAssignableFrom(type))
-			return ConvertFromSystemDelegate(safe_cast<System::Delegate^>(iObject));
-	
-	
-		if (type->IsGenericType)
+	case ConverterKind::Char:
 		{
-			if(type->GetGenericTypeDefinition() == System::Collections::Generic::Dictionary::typeid)
-			{
-				return ConvertFromSystemDictionary(iObject);
-			}
-			if (type->IsGenericType && (type->GetGenericTypeDefinition() == System::Collections::Generic::List::typeid))
-				return ConvertFromSystemList(iObject);
-		}
-
-
-		if (System::Collections::IDictionary::typeid->IsAssignableFrom(type)){
-			//Only do this if no fields defined on this type
-			if (type->GetFields(System::Reflection::BindingFlags::DeclaredOnly | System::Reflection::BindingFlags::Instance )->Length == 0){
-				return ConvertFromSystemDictionary(iObject);
-			}
+			uint16_t c = (uint16_t)safe_cast<wchar_t>(iObject);
+			return v8::String::NewFromTwoByte(isolate, &c, v8::NewStringType::kNormal, 1).ToLocalChecked();
 		}
-
-		if (System::Exception::typeid->IsAssignableFrom(type))
+	case ConverterKind::Int64:
+		return v8::Number::New(isolate, (double)safe_cast<long long>(iObject));
+	case ConverterKind::Int16:
+		return v8::Int32::New(isolate, safe_cast<short>(iObject));
+	case ConverterKind::SByte:
+		return v8::Int32::New(isolate, safe_cast<signed char>(iObject));
+	case ConverterKind::Byte:
+		return v8::Int32::New(isolate, safe_cast<unsigned char>(iObject));
+	case ConverterKind::UInt16:
+		return v8::Uint32::New(isolate, safe_cast<unsigned short>(iObject));
+	case ConverterKind::UInt32:
+		return v8::Number::New(isolate, safe_cast<unsigned int>(iObject));  // I tried v8::Uint32, but it converted MaxInt to -1.
+	case ConverterKind::UInt64:
+		return v8::Number::New(isolate, (double)safe_cast<unsigned long long>(iObject));
+	case ConverterKind::Single:
+		return v8::Number::New(isolate, safe_cast<float>(iObject));
+	case ConverterKind::Decimal:
+		return v8::Number::New(isolate, (double)safe_cast<System::Decimal>(iObject));
+	case ConverterKind::DateTime:
+		return v8::Date::New(isolate->GetCurrentContext(), SystemInterop::ConvertFromSystemDateTime(safe_cast<System::DateTime^>(iObject))).ToLocalChecked();
+	case ConverterKind::String:
+		return ConvertStringToV8(isolate, safe_cast<System::String^>(iObject));
+	case ConverterKind::Array:
+		return ConvertFromSystemArray(safe_cast<System::Array^>(iObject));
+	case ConverterKind::TypedArray:
+		return ConvertFromSystemNumericArray(safe_cast<System::Array^>(iObject));
+	case ConverterKind::Regex:
+		return ConvertFromSystemRegex(safe_cast<System::Text::RegularExpressions::Regex^>(iObject));
+	case ConverterKind::Delegate:
+		return ConvertFromSystemDelegate(safe_cast<System::Delegate^>(iObject));
+	case ConverterKind::Dictionary:
+		return ConvertFromSystemDictionary(iObject);
+	case ConverterKind::List:
+		return ConvertFromSystemList(iObject);
+	case ConverterKind::Exception:
 		{
 			// Converting exceptions to proper v8 Error objects has the advantage that
 			// they will come with stack traces.  We tuck the original Exception into
@@ -254,11 +328,147 @@ JavascriptInterop::ConvertToV8(System::Object^ iObject)
 			error_o->Set(isolate->GetCurrentContext(), key, WrapObject(iObject)).ToChecked();
 			return error_o;
 		}
-
+	default:
 		return WrapObject(iObject);
 	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Strings up to this long are converted through buffers on the stack.
+static const int StackStringLength = 256;
+
+Local<String>
+JavascriptInterop::ConvertStringToV8(v8::Isolate *iIsolate, System::String^ iString)
+{
+	Local<v8::String> external = JavascriptExternalString::New(iIsolate, iString);
+	if (!external.IsEmpty())
+		return external;
+
+	// v8 would narrow Latin-1 strings itself, but only after scanning for
+	// the terminator and then for wide characters, one at a time.
+	int length = iString->Length;
+	pin_ptr<const wchar_t> charsPtr = PtrToStringChars(iString);
+	const uint16_t *chars = (const uint16_t *) charsPtr;
+	uint8_t stackBytes[StackStringLength];
+	std::unique_ptr<uint8_t[]> heapBytes;
+	uint8_t *bytes = stackBytes;
+	if (length > StackStringLength)
+	{
+		heapBytes.reset(new uint8_t[length]);
+		bytes = heapBytes.get();
+	}
+	if (NarrowToLatin1(chars, bytes, length))
+		return v8::String::NewFromOneByte(iIsolate, bytes, v8::NewStringType::kNormal, length).ToLocalChecked();
+	return v8::String::NewFromTwoByte(iIsolate, chars, v8::NewStringType::kNormal, length).ToLocalChecked();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::String^
+JavascriptInterop::ConvertStringFromV8(v8::Isolate *iIsolate, Local<String> iString)
+{
+	int length = iString->Length();
+	if (length == 0)
+		return System::String::Empty;
+
+	uint16_t stackChars[StackStringLength];
+	std::unique_ptr<uint16_t[]> heapChars;
+	uint16_t *chars = stackChars;
+	if (length > StackStringLength)
+	{
+		heapChars.reset(new uint16_t[length]);
+		chars = heapChars.get();
+	}
+	if (iString->IsOneByte())
+	{
+		uint8_t stackBytes[StackStringLength];
+		std::unique_ptr<uint8_t[]> heapBytes;
+		uint8_t *bytes = stackBytes;
+		if (length > StackStringLength)
+		{
+			heapBytes.reset(new uint8_t[length]);
+			bytes = heapBytes.get();
+		}
+		iString->WriteOneByte(iIsolate, bytes, 0, length, String::NO_NULL_TERMINATION);
+		WidenFromLatin1(bytes, chars, length);
+	}
+	else
+		iString->Write(iIsolate, chars, 0, length, String::NO_NULL_TERMINATION);
+	return gcnew System::String((wchar_t*) chars, 0, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The order of the tests matters, e.g. for types that are both an
+// IDictionary and something more specific.
+ConverterKind
+ConverterCache::Classify(System::Type^ type)
+{
+	if (type->IsValueType)
+	{
+		// Common types first.
+		if (type == System::Int32::typeid)
+			return ConverterKind::Int32;
+		if (type == System::Double::typeid)
+			return ConverterKind::Double;
+		if (type == System::Boolean::typeid)
+			return ConverterKind::Boolean;
+		if (type->IsEnum)
+			return ConverterKind::Enum;
+		if (type == System::Char::typeid)
+			return ConverterKind::Char;
+		if (type == System::Int64::typeid)
+			return ConverterKind::Int64;
+		if (type == System::Int16::typeid)
+			return ConverterKind::Int16;
+		if (type == System::SByte::typeid)
+			return ConverterKind::SByte;
+		if (type == System::Byte::typeid)
+			return ConverterKind::Byte;
+		if (type == System::UInt16::typeid)
+			return ConverterKind::UInt16;
+		if (type == System::UInt32::typeid)
+			return ConverterKind::UInt32;
+		if (type == System::UInt64::typeid)
+			return ConverterKind::UInt64;
+		if (type == System::Single::typeid)
+			return ConverterKind::Single;
+		if (type == System::Decimal::typeid)
+			return ConverterKind::Decimal;
+		if (type == System::DateTime::typeid)
+			return ConverterKind::DateTime;
+	}
+	if (type == System::String::typeid)
+		return ConverterKind::String;
+	if (type == cli::array<System::Byte>::typeid || type == cli::array<float>::typeid || type == cli::array<double>::typeid)
+		return ConverterKind::TypedArray;
+	if (type->IsArray)
+		return ConverterKind::Array;
+	if (type == System::Text::RegularExpressions::Regex::typeid)
+		return ConverterKind::Regex;
+	if (System::Delegate::typeid->IsAssignableFrom(type))
+		return ConverterKind::Delegate;
+
+	if (type->IsGenericType)
+	{
+		if (type->GetGenericTypeDefinition() == System::Collections::Generic::Dictionary::typeid)
+			return ConverterKind::Dictionary;
+		if (type->GetGenericTypeDefinition() == System::Collections::Generic::List::typeid)
+			return ConverterKind::List;
+	}
 
-	return Null(isolate);
+	if (System::Collections::IDictionary::typeid->IsAssignableFrom(type))
+	{
+		//Only do this if no fields defined on this type
+		if (type->GetFields(System::Reflection::BindingFlags::DeclaredOnly | System::Reflection::BindingFlags::Instance)->Length == 0)
+			return ConverterKind::Dictionary;
+	}
+
+	if (System::Exception::typeid->IsAssignableFrom(type))
+		return ConverterKind::Exception;
+
+	return ConverterKind::Wrap;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -271,10 +481,18 @@ JavascriptInterop::WrapObject(System::Object^ iObject)
 
 	if (context != nullptr)
 	{
-		Handle<ObjectTemplate> templ = context->GetObjectWrapperTemplate();
+		// Hand out the same wrapper for as long as v8 keeps it alive.
+		JavascriptExternal *external = context->WrapObject(iObject);
+		Handle<Object> object = external->GetWrapper();
+		if (!object.IsEmpty())
+			return object;
+
+		// A new external, which a garbage collection won't touch.
+		Handle<ObjectTemplate> templ = context->GetObjectWrapperTemplate(iObject->GetType());
 		v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
-		Handle<Object> object = templ->NewInstance(isolate->GetCurrentContext()).ToLocalChecked();
-		object->SetInternalField(0, External::New(isolate, context->WrapObject(iObject)));
+		object = templ->NewInstance(isolate->GetCurrentContext()).ToLocalChecked();
+		external->SetWrapper(object);
+		object->SetInternalField(0, External::New(isolate, external));
 
 		return object;
 	}
@@ -316,13 +534,16 @@ System::Object^
 JavascriptInterop::ConvertArrayFromV8(Handle<Value> iValue, ConvertedObjects &already_converted)
 {
 	v8::Handle<v8::Array> object = v8::Handle<v8::Array>::Cast(iValue->ToObject(JavascriptContext::GetCurrentIsolate()));
+	Local<Context> context = JavascriptContext::GetCurrentIsolate()->GetCurrentContext();
 	int length = object->Length();
 	cli::array<System::Object^>^ results = gcnew cli::array<System::Object^>(length);
 
 	// Populate the .NET Array with the v8 Array
 	for(int i = 0; i < length; i++)
 	{
-		results->SetValue(ConvertFromV8(object->Get(i), already_converted), i);
+		Local<Value> element;
+		if (object->Get(context, i).ToLocal(&element))
+			results[i] = ConvertFromV8(element, already_converted);
 	}
 
 	return results;
@@ -330,6 +551,106 @@ JavascriptInterop::ConvertArrayFromV8(Handle<Value> iValue, ConvertedObjects &al
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Reads an array of numbers straight into a double[] or int[], without
+// boxing each element.  v8 doesn't let us at the elements in bulk, but
+// this still saves the allocations and the type tests per element.
+// Returns null for other element types, or if an element doesn't fit, so
+// that the caller can fall back on converting one element at a time.
+System::Array^
+JavascriptInterop::ConvertNumberArrayFromV8(Handle<v8::Array> iArray, System::Type^ iElementType)
+{
+	Local<Context> context = JavascriptContext::GetCurrentIsolate()->GetCurrentContext();
+	int length = iArray->Length();
+	Local<Value> element;
+
+	if (iElementType == double::typeid)
+	{
+		cli::array<double>^ results = gcnew cli::array<double>(length);
+		for (int i = 0; i < length; i++)
+		{
+			if (!iArray->Get(context, i).ToLocal(&element) || !element->IsNumber())
+				return nullptr;
+			results[i] = element.As<v8::Number>()->Value();
+		}
+		return results;
+	}
+
+	if (iElementType == int::typeid)
+	{
+		cli::array<int>^ results = gcnew cli::array<int>(length);
+		for (int i = 0; i < length; i++)
+		{
+			if (!iArray->Get(context, i).ToLocal(&element) || !element->IsInt32())
+				return nullptr;
+			results[i] = element.As<v8::Int32>()->Value();
+		}
+		return results;
+	}
+
+	return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Copies the contents in one go.  Views come back as arrays of their
+// element type, and bare ArrayBuffers and DataViews as byte[].
+// Uint8ClampedArray only clamps on the way in, so it is plain byte[] too.
+System::Object^
+JavascriptInterop::ConvertTypedArrayFromV8(Handle<Value> iValue)
+{
+	System::Type^ elementType;
+	if (iValue->IsFloat64Array())
+		elementType = double::typeid;
+	else if (iValue->IsFloat32Array())
+		elementType = float::typeid;
+	else if (iValue->IsInt32Array())
+		elementType = int::typeid;
+	else if (iValue->IsUint32Array())
+		elementType = unsigned int::typeid;
+	else if (iValue->IsInt16Array())
+		elementType = short::typeid;
+	else if (iValue->IsUint16Array())
+		elementType = unsigned short::typeid;
+	else if (iValue->IsInt8Array())
+		elementType = System::SByte::typeid;
+	else if (iValue->IsBigInt64Array())
+		elementType = long long::typeid;
+	else if (iValue->IsBigUint64Array())
+		elementType = unsigned long long::typeid;
+	else if (iValue->IsUint8Array() || iValue->IsUint8ClampedArray())
+		elementType = System::Byte::typeid;
+	else if (iValue->IsArrayBuffer() || iValue->IsDataView())
+		elementType = System::Byte::typeid;
+	else
+		throw gcnew System::NotSupportedException("Unsupported typed array.");
+
+	size_t byteLength;
+	if (iValue->IsArrayBuffer())
+		byteLength = Handle<ArrayBuffer>::Cast(iValue)->ByteLength();
+	else
+		byteLength = Handle<ArrayBufferView>::Cast(iValue)->ByteLength();
+	System::Array^ result = System::Array::CreateInstance(elementType, (int)(byteLength / System::Runtime::InteropServices::Marshal::SizeOf(elementType)));
+	if (byteLength == 0)
+		return result;
+
+	System::Runtime::InteropServices::GCHandle pinned = System::Runtime::InteropServices::GCHandle::Alloc(result, System::Runtime::InteropServices::GCHandleType::Pinned);
+	try
+	{
+		void *destination = pinned.AddrOfPinnedObject().ToPointer();
+		if (iValue->IsArrayBuffer())
+			memcpy(destination, Handle<ArrayBuffer>::Cast(iValue)->GetContents().Data(), byteLength);
+		else
+			Handle<ArrayBufferView>::Cast(iValue)->CopyContents(destination, byteLength);
+	}
+	finally
+	{
+		pinned.Free();
+	}
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 System::Object^
 JavascriptInterop::ConvertObjectFromV8(Handle<Object> iObject, ConvertedObjects &already_converted)
 {
@@ -412,6 +733,22 @@ JavascriptInterop::ConvertFromSystemArray(System::Array^ iArray)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// The typed array is a view onto the .NET array's own memory, so writes on
+// either side are seen by the other.
+v8::Handle<v8::Value>
+JavascriptInterop::ConvertFromSystemNumericArray(System::Array^ iArray)
+{
+	Local<ArrayBuffer> buffer = JavascriptContext::GetCurrent()->NewPinnedArrayBuffer(iArray);
+	size_t length = iArray->Length;
+	if (iArray->GetType() == cli::array<double>::typeid)
+		return Float64Array::New(buffer, 0, length);
+	if (iArray->GetType() == cli::array<float>::typeid)
+		return Float32Array::New(buffer, 0, length);
+	return Uint8Array::New(buffer, 0, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Handle<Value>
 JavascriptInterop::ConvertFromSystemRegex(System::Text::RegularExpressions::Regex^ iRegex)
 {
@@ -480,10 +817,16 @@ JavascriptInterop::ConvertFromSystemDelegate(System::Delegate^ iDelegate)
 {
 	JavascriptContext^ context = JavascriptContext::GetCurrent();
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
-	v8::Handle<v8::External> external = v8::External::New(isolate, context->WrapObject(iDelegate));
-
-	v8::Handle<v8::FunctionTemplate> method = v8::FunctionTemplate::New(isolate, DelegateInvoker, external);
-	return method->GetFunction();
+	JavascriptExternal *wrapper = context->WrapObject(iDelegate);
+	v8::Local<v8::Object> existing = wrapper->GetWrapper();
+	if (!existing.IsEmpty())
+		return existing;
+
+	// Not made from a template, because v8 would keep template functions
+	// alive for the life of the context.
+	v8::Handle<v8::Function> method = v8::Function::New(isolate->GetCurrentContext(), DelegateInvoker, v8::External::New(isolate, wrapper)).ToLocalChecked();
+	wrapper->SetWrapper(method);
+	return method;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -572,10 +915,32 @@ JavascriptInterop::IsSystemObject(Handle<Value> iValue)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void
+JavascriptInterop::PropertyGetter(Local<String> iName, const PropertyCallbackInfo<Value>& iInfo)
+{
+	Handle<External> external = Handle<External>::Cast(iInfo.Holder()->GetInternalField(0));
+	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
+	int index = Local<v8::Integer>::Cast(iInfo.Data())->Value();
+	iInfo.GetReturnValue().Set(wrapper->GetProperty(wrapper->GetMembers()->Properties[index]));  // good value or exception
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptInterop::PropertySetter(Local<String> iName, Local<Value> iValue, const PropertyCallbackInfo<void>& iInfo)
+{
+	Handle<External> external = Handle<External>::Cast(iInfo.Holder()->GetInternalField(0));
+	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
+	int index = Local<v8::Integer>::Cast(iInfo.Data())->Value();
+	wrapper->SetProperty(wrapper->GetMembers()->Properties[index], iValue);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void
 JavascriptInterop::Getter(Local<String> iName, const PropertyCallbackInfo<Value>& iInfo)
 {
-	wstring name = (wchar_t*) *String::Value(JavascriptContext::GetCurrentIsolate(), iName);
+	System::String^ name = JavascriptNameTable::Get(iInfo.GetIsolate())->GetName(iName);
 	Handle<External> external = Handle<External>::Cast(iInfo.Holder()->GetInternalField(0));
 	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
 	Handle<Function> function;
@@ -595,9 +960,9 @@ JavascriptInterop::Getter(Local<String> iName, const PropertyCallbackInfo<Value>
 	}
 
 	// map toString with ToString
-	if (wstring((wchar_t*) *String::Value(JavascriptContext::GetCurrentIsolate(), iName)) == L"toString")
+	if (System::String::Equals(name, "toString"))
 	{
-		function = wrapper->GetMethod(L"ToString");
+		function = wrapper->GetMethod("ToString");
 		if (!function.IsEmpty()) {
 			iInfo.GetReturnValue().Set(function);
 			return;
@@ -606,7 +971,7 @@ JavascriptInterop::Getter(Local<String> iName, const PropertyCallbackInfo<Value>
 
 	// member not found
 	if ((wrapper->GetOptions() & SetParameterOptions::RejectUnknownProperties) == SetParameterOptions::RejectUnknownProperties) {
-		iInfo.GetReturnValue().Set(JavascriptContext::GetCurrentIsolate()->ThrowException(JavascriptInterop::ConvertToV8("Unknown member: " + gcnew System::String((wchar_t*) *String::Value(JavascriptContext::GetCurrentIsolate(), iName)))));
+		iInfo.GetReturnValue().Set(JavascriptContext::GetCurrentIsolate()->ThrowException(JavascriptInterop::ConvertToV8("Unknown member: " + name)));
 		return;
 	}
 	iInfo.GetReturnValue().Set(Handle<Value>());
@@ -617,7 +982,7 @@ JavascriptInterop::Getter(Local<String> iName, const PropertyCallbackInfo<Value>
 void
 JavascriptInterop::Setter(Local<String> iName, Local<Value> iValue, const PropertyCallbackInfo<Value>& iInfo)
 {
-	wstring name = (wchar_t*) *String::Value(JavascriptContext::GetCurrentIsolate(), iName);
+	System::String^ name = JavascriptNameTable::Get(iInfo.GetIsolate())->GetName(iName);
 	Handle<External> external = Handle<External>::Cast(iInfo.Holder()->GetInternalField(0));
 	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
 
@@ -667,37 +1032,80 @@ JavascriptInterop::IndexSetter(uint32_t iIndex, Local<Value> iValue, const Prope
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// For methods returned by JavascriptExternal::GetMethod(), which are shared
+// by every object of a type.  The member's name is in the data.
 void
 JavascriptInterop::Invoker(const v8::FunctionCallbackInfo<Value>& iArgs)
+{
+	// The signature has already made sure that the holder is a generic
+	// wrapper, but it may wrap an object of another type.
+	GenericMethod *method = (GenericMethod *) Handle<External>::Cast(iArgs.Data())->Value();
+	Handle<External> external = Handle<External>::Cast(iArgs.Holder()->GetInternalField(0));
+	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
+	System::Object^ self = wrapper->GetObject();
+	if (!method->type->IsInstanceOfType(self))
+	{
+		v8::Isolate *isolate = iArgs.GetIsolate();
+		iArgs.GetReturnValue().Set(isolate->ThrowException(v8::Exception::TypeError(
+			v8::String::NewFromUtf8(isolate, "Illegal invocation", v8::NewStringType::kNormal).ToLocalChecked())));
+		return;
+	}
+	InvokeMethod(iArgs, self, method->name);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// For methods on the prototypes made by NewObjectWrapperTemplate(Type).
+void
+JavascriptInterop::PrototypeInvoker(const v8::FunctionCallbackInfo<Value>& iArgs)
+{
+	Handle<External> external = Handle<External>::Cast(iArgs.Holder()->GetInternalField(0));
+	JavascriptExternal* wrapper = (JavascriptExternal*) external->Value();
+	int index = Local<v8::Integer>::Cast(iArgs.Data())->Value();
+	InvokeMethod(iArgs, wrapper->GetObject(), wrapper->GetMembers()->Methods[index]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptInterop::InvokeMethod(const v8::FunctionCallbackInfo<Value>& iArgs, System::Object^ self, System::String^ memberName)
 {
 	v8::Isolate *isolate = JavascriptContext::GetCurrentIsolate();
-	System::Object^ data = UnwrapObject(Handle<External>::Cast(iArgs.Data()));
-	System::Reflection::MethodInfo^ bestMethod;
+	CompiledMethod^ bestMethod;
 	cli::array<System::Object^>^ suppliedArguments;
 	cli::array<System::Object^>^ bestMethodArguments;
-	cli::array<System::Object^>^ objectInfo;
 	int bestMethodMatchedArgs = -1;
 	System::Object^ ret;
 
-	// get target and member's name
-	objectInfo = safe_cast<cli::array<System::Object^>^>(data);
-	System::Object^ self = objectInfo[0];
-	// System::Object^ holder = UnwrapObject(iArgs.Holder());
-	System::Type^ holderType = self->GetType(); 
-	
 	// get members
 	System::Type^ type = self->GetType();
-	System::String^ memberName = (System::String^)objectInfo[1];
-	cli::array<System::Reflection::MemberInfo^>^ members = type->GetMember(memberName);
 
-	if (members->Length > 0 && members[0]->MemberType == System::Reflection::MemberTypes::Method)
+	// parameters
+	suppliedArguments = gcnew cli::array<System::Object^>(iArgs.Length());
+	ConvertedObjects already_converted;
+	for (int i = 0; i < iArgs.Length(); i++)
+		suppliedArguments[i] = ConvertFromV8(iArgs[i], already_converted);
+
+	// The choice of method only depends on the types of the arguments,
+	// unless a conversion fails, so calls with the same types of argument
+	// usually get the same method.
+	JavascriptMemberCache^ cache = JavascriptMemberCache::Get(type);
+	OverloadKey^ key = gcnew OverloadKey(memberName, suppliedArguments);
+	bestMethod = cache->GetOverload(key);
+	if (bestMethod != nullptr)
+	{
+		bestMethodArguments = bestMethod->ConvertArguments(suppliedArguments);
+		if (bestMethodArguments == nullptr)
+			bestMethod = nullptr;
+	}
+
+	cli::array<System::Reflection::MemberInfo^>^ members = bestMethod != nullptr ? nullptr : type->GetMember(memberName);
+	if (members != nullptr && members->Length > 0 && members[0]->MemberType == System::Reflection::MemberTypes::Method)
 	{
-		// parameters
-		suppliedArguments = gcnew cli::array<System::Object^>(iArgs.Length());
-		ConvertedObjects already_converted;
-		for (int i = 0; i < iArgs.Length(); i++)
-			suppliedArguments[i] = ConvertFromV8(iArgs[i], already_converted);
-		
+		// Whether the choice would be the same for other values of the same types.
+		bool cacheable = true;
+		System::Reflection::MethodInfo^ bestMethodInfo;
+
 		// look for best matching method
 		for (int i = 0; i < members->Length; i++)
 		{
@@ -744,12 +1152,15 @@ JavascriptInterop::Invoker(const v8::FunctionCallbackInfo<Value>& iArgs)
 
 				// skip if a conversion failed
 				if (failed > 0)
+				{
+					cacheable = false;
 					continue;
+				}
 
 				// remember best match
 				if (match > bestMethodMatchedArgs)
 				{
-					bestMethod = method;
+					bestMethodInfo = method;
 					bestMethodArguments = arguments;
 					bestMethodMatchedArgs = match;
 				}
@@ -757,7 +1168,7 @@ JavascriptInterop::Invoker(const v8::FunctionCallbackInfo<Value>& iArgs)
 				{
 					if (suppliedArguments->Length == parametersInfo->Length) // Prefer method with the most matches and the same length of arguments
 					{
-						bestMethod = method;
+						bestMethodInfo = method;
 						bestMethodArguments = arguments;
 						bestMethodMatchedArgs = match;
 					}
@@ -781,6 +1192,13 @@ JavascriptInterop::Invoker(const v8::FunctionCallbackInfo<Value>& iArgs)
 					//break;
 			}
 		}
+
+		if (bestMethodInfo != nullptr)
+		{
+			bestMethod = cache->GetCompiledMethod(bestMethodInfo);
+			if (cacheable)
+				cache->AddOverload(key, bestMethod);
+		}
 	}
 
 	if (bestMethod != nullptr)
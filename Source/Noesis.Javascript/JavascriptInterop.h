@@ -61,6 +61,66 @@ private:
 };
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// How ConvertToV8() treats values of a given .NET type.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+enum class ConverterKind
+{
+	Int32,
+	Double,
+	Boolean,
+	Enum,
+	Char,
+	Int64,
+	Int16,
+	SByte,
+	Byte,
+	UInt16,
+	UInt32,
+	UInt64,
+	Single,
+	Decimal,
+	DateTime,
+	String,
+	Array,
+	TypedArray,
+	Regex,
+	Delegate,
+	Dictionary,
+	List,
+	Exception,
+	Wrap
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// ConverterCache
+//
+// Remembers the ConverterKind of each type ConvertToV8() has seen, so that
+// the type tests and reflection behind it are done once per type rather
+// than once per value.  Shared by all threads.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class ConverterCache abstract sealed
+{
+public:
+	static ConverterKind GetKind(System::Type^ iType)
+	{
+		ConverterKind kind;
+		if (!sKinds->TryGetValue(iType, kind))
+		{
+			kind = Classify(iType);
+			sKinds->TryAdd(iType, kind);
+		}
+		return kind;
+	}
+
+private:
+	static ConverterKind Classify(System::Type^ iType);
+
+	static System::Collections::Concurrent::ConcurrentDictionary<System::Type^, ConverterKind> ^sKinds = gcnew System::Collections::Concurrent::ConcurrentDictionary<System::Type^, ConverterKind>();
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // JavascriptInterop
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -71,16 +131,31 @@ class JavascriptInterop
 	////////////////////////////////////////////////////////////
 public:
 
-	static Handle<ObjectTemplate> NewObjectWrapperTemplate();
+	// The generic template is the instance template of the result.
+	static Handle<FunctionTemplate> NewObjectWrapperTemplate();
+
+	// Returns an empty handle for types that need the generic template.
+	static Handle<FunctionTemplate> NewObjectWrapperTemplate(System::Type^ iType);
 
 	static System::Object^ ConvertFromV8(Handle<Value> iValue);
 
+	// Throws InvalidCastException if iValue can't be made into an iType.
+	static System::Object^ ConvertFromV8(Handle<Value> iValue, System::Type^ iType);
+
 	static Handle<Value> ConvertToV8(System::Object^ iObject);
 
+	// Makes a one-byte v8 string when every character fits in Latin-1.
+	static Local<String> ConvertStringToV8(v8::Isolate *iIsolate, System::String^ iString);
+
+	static System::String^ ConvertStringFromV8(v8::Isolate *iIsolate, Local<String> iString);
+
 	static System::Object^ UnwrapObject(Handle<Value> iValue);
 
+	// For templates made by JavascriptIsolate::GetMethodTemplate().
 	static void Invoker(const v8::FunctionCallbackInfo<Value>& iArgs);
 
+	static void PrototypeInvoker(const v8::FunctionCallbackInfo<Value>& iArgs);
+
 	static Handle<Value> HandleTargetInvocationException(System::Reflection::TargetInvocationException^ exception);
 
 private:
@@ -94,6 +169,8 @@ private:
 
 	static v8::Handle<v8::Value> ConvertFromSystemArray(System::Array^ iArray);
 
+	static v8::Handle<v8::Value> ConvertFromSystemNumericArray(System::Array^ iArray);
+
     static v8::Handle<v8::Value> ConvertFromSystemRegex(System::Text::RegularExpressions::Regex^ iRegex);
 
 	static v8::Handle<v8::Value> ConvertFromSystemDictionary(System::Object^ iObject);
@@ -110,8 +187,18 @@ private:
 
 	static System::Object^ ConvertArrayFromV8(Handle<Value> iValue, ConvertedObjects &already_converted);
 
+	static System::Object^ ConvertTypedArrayFromV8(Handle<Value> iValue);
+
+	static System::Array^ ConvertNumberArrayFromV8(Handle<v8::Array> iArray, System::Type^ iElementType);
+
 	static Handle<Object> WrapFunction(System::Object^ iObject, System::String^ iName);
 
+	static void InvokeMethod(const v8::FunctionCallbackInfo<Value>& iArgs, System::Object^ self, System::String^ memberName);
+
+	static void PropertyGetter(Local<String> iName, const PropertyCallbackInfo<Value>& iInfo);
+
+	static void PropertySetter(Local<String> iName, Local<Value> iValue, const PropertyCallbackInfo<void>& iInfo);
+
 	static void Getter(Local<String> iName, const PropertyCallbackInfo<Value>& iInfo);
 
 	static void Setter(Local<String> iName, Local<Value> iValue, const PropertyCallbackInfo<Value>& iInfo);
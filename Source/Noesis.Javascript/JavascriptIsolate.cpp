@@ -0,0 +1,637 @@
+#include <msclr\lock.h>
+#include <gcroot.h>
+#include "libplatform/libplatform.h"
+
+#include "JavascriptIsolate.h"
+#include "JavascriptArrayBufferAllocator.h"
+#include "JavascriptContext.h"
+#include "JavascriptHeapStatistics.h"
+#include "JavascriptInterop.h"
+#include "JavascriptMemoryManager.h"
+#include "JavascriptNameTable.h"
+#include "JavascriptPlatform.h"
+#include "JavascriptScript.h"
+#include "JavascriptSnapshot.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace msclr;
+using namespace v8;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The .NET side of an ArrayBuffer made by NewPinnedArrayBuffer().
+struct PinnedBuffer
+{
+	gcroot<System::Collections::Generic::HashSet<System::IntPtr>^> owner;
+	void *handle;  // the pinning GCHandle
+	int64_t length;  // reported to v8 as external memory
+	Persistent<ArrayBuffer> buffer;  // weak
+};
+
+static void
+FreePinnedBuffer(PinnedBuffer *iPinned)
+{
+	System::Runtime::InteropServices::GCHandle::FromIntPtr(System::IntPtr(iPinned->handle)).Free();
+	delete iPinned;
+}
+
+// Called by v8 in the middle of a garbage collection.
+static void
+PinnedBufferCollected(const WeakCallbackInfo<PinnedBuffer> &iInfo)
+{
+	PinnedBuffer *pinned = iInfo.GetParameter();
+	pinned->buffer.Reset();
+	iInfo.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(-pinned->length);
+	pinned->owner->Remove(System::IntPtr(pinned));
+	FreePinnedBuffer(pinned);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+	struct HeapLimitState
+	{
+		v8::Isolate *isolate;
+		bool reached;
+	};
+
+	// Called by v8 on the isolate's thread, from inside a garbage collection.
+	size_t NearHeapLimitCallback(void *data, size_t current_heap_limit, size_t initial_heap_limit)
+	{
+		HeapLimitState *state = (HeapLimitState *)data;
+		if (state->reached)
+			// Still going, even though it was terminated.  Let v8's fatal
+			// error handling take over.
+			return current_heap_limit;
+		state->reached = true;
+		state->isolate->TerminateExecution();
+
+		// The script needs some room to unwind in.
+		return current_heap_limit + initial_heap_limit / 2;
+	}
+#pragma managed(pop)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptIsolate::JavascriptIsolate()
+{
+	Initialise(nullptr, nullptr);
+}
+
+JavascriptIsolate::JavascriptIsolate(JavascriptSnapshot^ snapshot)
+{
+	if (snapshot == nullptr)
+		throw gcnew System::ArgumentNullException("snapshot");
+	Initialise(snapshot, nullptr);
+}
+
+JavascriptIsolate::JavascriptIsolate(JavascriptHeapLimits^ heapLimits)
+{
+	if (heapLimits == nullptr)
+		throw gcnew System::ArgumentNullException("heapLimits");
+	Initialise(nullptr, heapLimits);
+}
+
+JavascriptIsolate::JavascriptIsolate(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits)
+{
+	Initialise(snapshot, heapLimits);
+}
+
+void JavascriptIsolate::Initialise(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits)
+{
+	JavascriptContext::EnsureV8Initialised();
+	mCollectionLock = gcnew System::Object();
+
+	// Unfortunately the fatal error handler is not installed early enough to catch
+	// out-of-memory errors while creating new isolates
+	// (see my post Catching V8::FatalProcessOutOfMemory while creating an isolate (SetFatalErrorHandler does not work)).
+	// GetTotalHeapStatistics() can help callers decide not to create one.
+	v8::Isolate::CreateParams create_params;
+	size_t arrayBufferCap = heapLimits == nullptr ? 0 : (size_t)heapLimits->MaxArrayBufferMemoryMB * 1024 * 1024;
+	mAllocator = new JavascriptArrayBufferAllocator(arrayBufferCap);
+	create_params.array_buffer_allocator = mAllocator;
+	if (snapshot != nullptr)
+		create_params.snapshot_blob = snapshot->GetStartupData();
+	if (heapLimits != nullptr)
+	{
+		if (heapLimits->MaxOldSpaceSizeMB > 0)
+			create_params.constraints.set_max_old_space_size(heapLimits->MaxOldSpaceSizeMB);
+		// v8 sizes the young generation as three semi-spaces.
+		if (heapLimits->MaxYoungSpaceSizeMB > 0)
+			create_params.constraints.set_max_semi_space_size_in_kb(heapLimits->MaxYoungSpaceSizeMB * 1024 / 3);
+	}
+	mSnapshot = snapshot;
+	mIsolate = v8::Isolate::New(create_params);
+	mIsolate->SetFatalErrorHandler(FatalErrorCallback);
+
+	mHeapLimitState = new HeapLimitState();
+	mHeapLimitState->isolate = mIsolate;
+	mHeapLimitState->reached = false;
+	mIsolate->AddNearHeapLimitCallback(NearHeapLimitCallback, mHeapLimitState);
+	mNames = new JavascriptNameTable(mIsolate);
+
+	mCompiledScripts = gcnew CompiledScriptCache(32);
+	mTypeTemplates = gcnew System::Collections::Generic::Dictionary<System::Type^, System::IntPtr>();
+	mMethodTemplates = gcnew System::Collections::Generic::Dictionary<GenericMethodKey, System::IntPtr>();
+	mPinnedBuffers = gcnew System::Collections::Generic::HashSet<System::IntPtr>();
+	mContexts = gcnew System::Collections::Generic::List<JavascriptContext^>();
+	mScripts = gcnew System::Collections::Generic::HashSet<JavascriptScript^>();
+
+	{
+		v8::Locker v8ThreadLock(mIsolate);
+		v8::Isolate::Scope isolate_scope(mIsolate);
+		TakeHeapSample();
+	}
+	mLastUseTimestamp = System::Diagnostics::Stopwatch::GetTimestamp();
+	mSelf = gcnew System::WeakReference(this);
+	{
+		lock l(sIsolates);
+		sIsolates->Add(mSelf);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptIsolate::~JavascriptIsolate()
+{
+	this->!JavascriptIsolate();
+}
+
+// Nothing can reach us or our contexts by the time we are finalized, so
+// they can be torn down from the finalizer thread just as from Dispose().
+// None of them have finalizers of their own to have run first.
+JavascriptIsolate::!JavascriptIsolate()
+{
+	// Initialise() may have thrown before getting this far.
+	if (mCollectionLock == nullptr)
+		return;
+
+	// Cleared first, because disposing a context that owns us comes back here.
+	v8::Isolate *isolate;
+	{
+		lock l(mCollectionLock);
+		isolate = mIsolate;
+		mIsolate = NULL;
+	}
+	if (isolate == NULL)
+		return;
+	{
+		lock l(sIsolates);
+		sIsolates->Remove(mSelf);
+	}
+
+	cli::array<JavascriptContext^>^ contexts;
+	{
+		lock l(mContexts);
+		contexts = mContexts->ToArray();
+	}
+	for each (JavascriptContext^ context in contexts)
+		delete context;
+
+	// Not before the contexts go: they still leave scopes on the way out.
+	if (mMemoryPressure > 0)
+		System::GC::RemoveMemoryPressure(mMemoryPressure);
+	mMemoryPressure = 0;
+
+	{
+		v8::Locker v8ThreadLock(isolate);
+		v8::Isolate::Scope isolate_scope(isolate);
+		cli::array<JavascriptScript^>^ scripts;
+		{
+			lock l(mScripts);
+			scripts = gcnew cli::array<JavascriptScript^>(mScripts->Count);
+			mScripts->CopyTo(scripts);
+			mScripts->Clear();
+		}
+		for each (JavascriptScript^ script in scripts)
+			script->Release();
+		delete mCompiledScripts;
+		if (mObjectWrapperTemplate != NULL)
+		{
+			mObjectWrapperTemplate->Reset();
+			delete mObjectWrapperTemplate;
+			mObjectWrapperTemplate = NULL;
+		}
+		for each (System::IntPtr pointer in mTypeTemplates->Values)
+		{
+			Persistent<FunctionTemplate> *typeTemplate = (Persistent<FunctionTemplate> *)pointer.ToPointer();
+			if (typeTemplate != NULL)
+			{
+				typeTemplate->Reset();
+				delete typeTemplate;
+			}
+		}
+		mTypeTemplates->Clear();
+		for each (System::IntPtr pointer in mMethodTemplates->Values)
+		{
+			GenericMethod *method = (GenericMethod *)pointer.ToPointer();
+			method->function.Reset();
+			delete method;
+		}
+		mMethodTemplates->Clear();
+		for each (System::IntPtr pointer in mPinnedBuffers)
+		{
+			PinnedBuffer *pinned = (PinnedBuffer *)pointer.ToPointer();
+			pinned->buffer.Reset();
+			isolate->AdjustAmountOfExternalAllocatedMemory(-pinned->length);
+		}
+		delete mNames;
+		mNames = NULL;
+	}
+	isolate->Dispose();
+
+	// Only now that v8 is gone can the arrays move again.
+	for each (System::IntPtr pointer in mPinnedBuffers)
+		FreePinnedBuffer((PinnedBuffer *)pointer.ToPointer());
+	mPinnedBuffers->Clear();
+	delete mAllocator;
+	mAllocator = NULL;
+	delete mHeapLimitState;
+	mHeapLimitState = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptContext^
+JavascriptIsolate::CreateContext()
+{
+	if (mIsolate == NULL)
+		throw gcnew System::ObjectDisposedException("JavascriptIsolate");
+	return gcnew JavascriptContext(this, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int
+JavascriptIsolate::ContextCount::get()
+{
+	lock l(mContexts);
+	return mContexts->Count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool
+JavascriptIsolate::IsOutOfMemory::get()
+{
+	return mHeapLimitState != NULL && mHeapLimitState->reached;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptHeapStatistics^
+JavascriptIsolate::GetHeapStatistics()
+{
+	if (mIsolate == NULL)
+		throw gcnew System::ObjectDisposedException("JavascriptIsolate");
+	v8::Locker v8ThreadLock(mIsolate);
+	v8::Isolate::Scope isolate_scope(mIsolate);
+	TakeHeapSample();
+	return mLastHeapStatistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<JavascriptHeapSpaceStatistics^>^
+JavascriptIsolate::GetHeapSpaceStatistics()
+{
+	if (mIsolate == NULL)
+		throw gcnew System::ObjectDisposedException("JavascriptIsolate");
+	v8::Locker v8ThreadLock(mIsolate);
+	v8::Isolate::Scope isolate_scope(mIsolate);
+	int count = (int)mIsolate->NumberOfHeapSpaces();
+	cli::array<JavascriptHeapSpaceStatistics^>^ result = gcnew cli::array<JavascriptHeapSpaceStatistics^>(count);
+	for (int i = 0; i < count; i++)
+	{
+		v8::HeapSpaceStatistics space;
+		mIsolate->GetHeapSpaceStatistics(&space, i);
+		JavascriptHeapSpaceStatistics^ statistics = gcnew JavascriptHeapSpaceStatistics();
+		statistics->SpaceName = gcnew System::String(space.space_name());
+		statistics->SpaceSize = space.space_size();
+		statistics->SpaceUsedSize = space.space_used_size();
+		statistics->SpaceAvailableSize = space.space_available_size();
+		statistics->PhysicalSpaceSize = space.physical_space_size();
+		result[i] = statistics;
+	}
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptHeapStatistics^
+JavascriptIsolate::GetTotalHeapStatistics()
+{
+	JavascriptHeapStatistics^ total = gcnew JavascriptHeapStatistics();
+	total->SampledAt = System::DateTime::UtcNow;
+	for each (JavascriptIsolate^ isolate in GetIsolates())
+	{
+		JavascriptHeapStatistics^ statistics = isolate->mLastHeapStatistics;
+		if (statistics != nullptr)
+			total->Add(statistics);
+	}
+	return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::RunIdleTasks(System::TimeSpan iBudget)
+{
+	if (mIsolate == NULL)
+		throw gcnew System::ObjectDisposedException("JavascriptIsolate");
+	if (!JavascriptPlatform::IdleTasksEnabled)
+		throw gcnew System::InvalidOperationException("JavascriptPlatform.IdleTasksEnabled must be set before the first context is created.");
+	v8::Locker v8ThreadLock(mIsolate);
+	v8::Isolate::Scope isolate_scope(mIsolate);
+	v8::platform::RunIdleTasks(JavascriptPlatform::GetDefaultPlatform(), mIsolate, iBudget.TotalSeconds);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+long long
+JavascriptIsolate::ArrayBufferPoolMemory::get()
+{
+	return JavascriptArrayBufferAllocator::GetPooledBytes();
+}
+
+long long
+JavascriptIsolate::ArrayBufferPoolHits::get()
+{
+	return JavascriptArrayBufferAllocator::GetPoolHits();
+}
+
+long long
+JavascriptIsolate::ArrayBufferPoolMisses::get()
+{
+	return JavascriptArrayBufferAllocator::GetPoolMisses();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::SampleHeapStatistics()
+{
+	// Contexts being deleted by our finalizer still leave their scopes.
+	if (mIsolate == NULL)
+		return;
+	long long now = System::Diagnostics::Stopwatch::GetTimestamp();
+	if (mLastHeapStatistics != nullptr
+		&& now - mLastSampleTimestamp < System::Diagnostics::Stopwatch::Frequency * SampleIntervalMilliseconds / 1000)
+		return;
+	TakeHeapSample();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::TakeHeapSample()
+{
+	if (mIsolate == NULL)
+		return;
+	JavascriptHeapStatistics^ statistics = ReadHeapStatistics();
+	mLastHeapStatistics = statistics;
+	mLastSampleTimestamp = System::Diagnostics::Stopwatch::GetTimestamp();
+
+	// Adjusting the pressure in small steps would cost more than it is
+	// worth, and the CLR only looks at the running total anyway.
+	long long target = JavascriptMemoryManager::MemoryPressureEnabled
+		? (long long)(statistics->TotalHeapSize + statistics->ArrayBufferMemory) : 0;
+	long long delta = target - mMemoryPressure;
+	if (delta >= JavascriptMemoryManager::MemoryPressureGranularity)
+		System::GC::AddMemoryPressure(delta);
+	else if (-delta >= JavascriptMemoryManager::MemoryPressureGranularity || (target == 0 && delta < 0))
+		System::GC::RemoveMemoryPressure(-delta);
+	else
+		return;
+	mMemoryPressure = target;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::BeginUse()
+{
+	mInUse = true;
+}
+
+void
+JavascriptIsolate::EndUse()
+{
+	mLastUseTimestamp = System::Diagnostics::Stopwatch::GetTimestamp();
+	mIdleCollectionDone = false;
+	mInUse = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The checks are made without the v8 lock, so a script may start just
+// after them, in which case it waits for us.  We keep that wait short.
+bool
+JavascriptIsolate::CollectIfIdle(System::TimeSpan iDelay, double iBudgetSeconds)
+{
+	lock l(mCollectionLock);
+	if (mIsolate == NULL || mInUse || mIdleCollectionDone || IsOutOfMemory)
+		return false;
+	long long idle = System::Diagnostics::Stopwatch::GetTimestamp() - mLastUseTimestamp;
+	if (idle < (long long)(iDelay.TotalSeconds * System::Diagnostics::Stopwatch::Frequency))
+		return false;
+
+	v8::Locker v8ThreadLock(mIsolate);
+	v8::Isolate::Scope isolate_scope(mIsolate);
+	if (JavascriptPlatform::IdleTasksEnabled)
+		v8::platform::RunIdleTasks(JavascriptPlatform::GetDefaultPlatform(), mIsolate, iBudgetSeconds / 2);
+
+	// v8 wants an absolute deadline on the platform's clock.
+	double deadline = JavascriptPlatform::GetPlatform()->MonotonicallyIncreasingTime() + iBudgetSeconds;
+	mIdleCollectionDone = mIsolate->IdleNotificationDeadline(deadline);
+	TakeHeapSample();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::NotifyLowMemory()
+{
+	lock l(mCollectionLock);
+	if (mIsolate == NULL || IsOutOfMemory)
+		return;
+	if (mInUse)
+	{
+		// Safe from any thread.  v8 interrupts the script to collect.
+		mIsolate->MemoryPressureNotification(v8::MemoryPressureLevel::kCritical);
+		return;
+	}
+	v8::Locker v8ThreadLock(mIsolate);
+	v8::Isolate::Scope isolate_scope(mIsolate);
+	mIsolate->LowMemoryNotification();
+	TakeHeapSample();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<JavascriptIsolate^>^
+JavascriptIsolate::GetIsolates()
+{
+	System::Collections::Generic::List<JavascriptIsolate^>^ isolates = gcnew System::Collections::Generic::List<JavascriptIsolate^>();
+	lock l(sIsolates);
+	for each (System::WeakReference^ reference in sIsolates)
+	{
+		JavascriptIsolate^ isolate = safe_cast<JavascriptIsolate^>(reference->Target);
+		if (isolate != nullptr)
+			isolates->Add(isolate);
+	}
+	return isolates->ToArray();
+}
+
+int
+JavascriptIsolate::GetUnfinalizedCount()
+{
+	lock l(sIsolates);
+	return sIsolates->Count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptHeapStatistics^
+JavascriptIsolate::ReadHeapStatistics()
+{
+	v8::HeapStatistics heap;
+	mIsolate->GetHeapStatistics(&heap);
+
+	JavascriptHeapStatistics^ statistics = gcnew JavascriptHeapStatistics();
+	statistics->TotalHeapSize = heap.total_heap_size();
+	statistics->TotalHeapSizeExecutable = heap.total_heap_size_executable();
+	statistics->TotalPhysicalSize = heap.total_physical_size();
+	statistics->TotalAvailableSize = heap.total_available_size();
+	statistics->UsedHeapSize = heap.used_heap_size();
+	statistics->HeapSizeLimit = heap.heap_size_limit();
+	statistics->MallocedMemory = heap.malloced_memory();
+	statistics->PeakMallocedMemory = heap.peak_malloced_memory();
+	statistics->NumberOfNativeContexts = (int)heap.number_of_native_contexts();
+	statistics->NumberOfDetachedContexts = (int)heap.number_of_detached_contexts();
+	// Adjusting by zero is the documented way to read the current figure.
+	statistics->ExternalMemory = mIsolate->AdjustAmountOfExternalAllocatedMemory(0);
+	statistics->ArrayBufferMemory = mAllocator->GetBytesInUse();
+	statistics->PeakArrayBufferMemory = mAllocator->GetPeakBytesInUse();
+	statistics->ArrayBufferAllocations = mAllocator->GetAllocationCount();
+	statistics->FailedArrayBufferAllocations = mAllocator->GetFailedAllocationCount();
+	statistics->NumberOfIsolates = 1;
+	statistics->SampledAt = System::DateTime::UtcNow;
+	return statistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Local<ObjectTemplate>
+JavascriptIsolate::GetObjectWrapperTemplate()
+{
+	if (mObjectWrapperTemplate == NULL)
+		mObjectWrapperTemplate = new Persistent<FunctionTemplate>(mIsolate, JavascriptInterop::NewObjectWrapperTemplate());
+	return Local<FunctionTemplate>::New(mIsolate, *mObjectWrapperTemplate)->InstanceTemplate();
+}
+
+Local<ObjectTemplate>
+JavascriptIsolate::GetObjectWrapperTemplate(System::Type^ iType)
+{
+	System::IntPtr pointer;
+	if (!mTypeTemplates->TryGetValue(iType, pointer))
+	{
+		Local<FunctionTemplate> typeTemplate = JavascriptInterop::NewObjectWrapperTemplate(iType);
+		if (!typeTemplate.IsEmpty())
+			pointer = System::IntPtr(new Persistent<FunctionTemplate>(mIsolate, typeTemplate));
+		mTypeTemplates[iType] = pointer;
+	}
+	if (pointer == System::IntPtr::Zero)
+		return GetObjectWrapperTemplate();
+	return Local<FunctionTemplate>::New(mIsolate, *(Persistent<FunctionTemplate> *)pointer.ToPointer())->InstanceTemplate();
+}
+
+Local<ArrayBuffer>
+JavascriptIsolate::NewPinnedArrayBuffer(System::Array^ iArray)
+{
+	System::Runtime::InteropServices::GCHandle handle = System::Runtime::InteropServices::GCHandle::Alloc(iArray, System::Runtime::InteropServices::GCHandleType::Pinned);
+	int length = System::Buffer::ByteLength(iArray);
+	Local<ArrayBuffer> buffer = ArrayBuffer::New(mIsolate, handle.AddrOfPinnedObject().ToPointer(), length, ArrayBufferCreationMode::kExternalized);
+
+	// Otherwise v8 doesn't see the array, and feels no need to collect the
+	// small buffer object that keeps it pinned.
+	mIsolate->AdjustAmountOfExternalAllocatedMemory(length);
+
+	PinnedBuffer *pinned = new PinnedBuffer();
+	pinned->owner = mPinnedBuffers;
+	pinned->handle = System::Runtime::InteropServices::GCHandle::ToIntPtr(handle).ToPointer();
+	pinned->length = length;
+	pinned->buffer.Reset(mIsolate, buffer);
+	pinned->buffer.SetWeak(pinned, PinnedBufferCollected, WeakCallbackType::kParameter);
+	mPinnedBuffers->Add(System::IntPtr(pinned));
+	return buffer;
+}
+
+Local<FunctionTemplate>
+JavascriptIsolate::GetMethodTemplate(System::Type^ iType, System::String^ iName)
+{
+	GenericMethodKey key(iType, iName);
+	System::IntPtr pointer;
+	if (!mMethodTemplates->TryGetValue(key, pointer))
+	{
+		// The signature makes v8 reject receivers that aren't generic
+		// wrappers; Invoker() checks the wrapped object's type.
+		GetObjectWrapperTemplate();
+		Local<Signature> signature = Signature::New(mIsolate, Local<FunctionTemplate>::New(mIsolate, *mObjectWrapperTemplate));
+		GenericMethod *method = new GenericMethod();
+		method->type = iType;
+		method->name = iName;
+		method->function.Reset(mIsolate, FunctionTemplate::New(mIsolate, JavascriptInterop::Invoker, External::New(mIsolate, method), signature));
+		pointer = System::IntPtr(method);
+		mMethodTemplates[key] = pointer;
+	}
+	return Local<FunctionTemplate>::New(mIsolate, ((GenericMethod *)pointer.ToPointer())->function);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::AddContext(JavascriptContext^ iContext)
+{
+	lock l(mContexts);
+	mContexts->Add(iContext);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::RemoveContext(JavascriptContext^ iContext)
+{
+	lock l(mContexts);
+	mContexts->Remove(iContext);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::AddScript(JavascriptScript^ iScript)
+{
+	lock l(mScripts);
+	mScripts->Add(iScript);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptIsolate::RemoveScript(JavascriptScript^ iScript)
+{
+	lock l(mScripts);
+	mScripts->Remove(iScript);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,335 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+#include <gcroot.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ref class JavascriptContext;
+ref class JavascriptHeapStatistics;
+ref class JavascriptHeapSpaceStatistics;
+ref class JavascriptSnapshot;
+ref class CompiledScriptCache;
+ref class JavascriptScript;
+class JavascriptArrayBufferAllocator;
+class JavascriptNameTable;
+struct HeapLimitState;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The data of each template made by JavascriptIsolate::GetMethodTemplate().
+struct GenericMethod
+{
+	gcroot<System::Type^> type;
+	gcroot<System::String^> name;
+	v8::Persistent<v8::FunctionTemplate> function;
+};
+
+// Identifies a GenericMethod.  A struct, so that looking one up allocates
+// nothing.  The names come from JavascriptNameTable, so they usually
+// compare equal by reference.
+value struct GenericMethodKey : System::IEquatable<GenericMethodKey>
+{
+	System::Type^ type;
+	System::String^ name;
+
+	GenericMethodKey(System::Type^ iType, System::String^ iName) : type(iType), name(iName) {}
+
+	virtual bool Equals(GenericMethodKey iOther) { return type == iOther.type && System::String::Equals(name, iOther.name); }
+
+	virtual bool Equals(System::Object^ iOther) override
+	{
+		return iOther != nullptr && iOther->GetType() == GenericMethodKey::typeid && Equals(safe_cast<GenericMethodKey>(iOther));
+	}
+
+	virtual int GetHashCode() override { return type->GetHashCode() * 31 + name->GetHashCode(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptHeapLimits
+//
+// Caps on the size of an isolate's heap.  Zero leaves v8's default in place.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptHeapLimits
+{
+public:
+	// Long-lived objects.  This is the one that usually runs out.
+	property int MaxOldSpaceSizeMB
+	{
+		int get() { return mMaxOldSpaceSizeMB; }
+		void set(int value) { mMaxOldSpaceSizeMB = value; }
+	}
+
+	// Newly allocated objects, before they survive a couple of garbage
+	// collections.
+	property int MaxYoungSpaceSizeMB
+	{
+		int get() { return mMaxYoungSpaceSizeMB; }
+		void set(int value) { mMaxYoungSpaceSizeMB = value; }
+	}
+
+	// ArrayBuffer contents, which live outside the v8 heap.  Allocations
+	// past this fail with a RangeError in the script.  The cap is shared by
+	// every context on the isolate.  Typed arrays made
+	// from .NET arrays don't count: they use the array's own memory.
+	property int MaxArrayBufferMemoryMB
+	{
+		int get() { return mMaxArrayBufferMemoryMB; }
+		void set(int value) { mMaxArrayBufferMemoryMB = value; }
+	}
+
+private:
+	int mMaxOldSpaceSizeMB;
+	int mMaxYoungSpaceSizeMB;
+	int mMaxArrayBufferMemoryMB;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptIsolate
+//
+// A v8 heap that can host many JavascriptContexts.  Each context gets its
+// own global scope, but they share the heap, the builtins, the templates we
+// use to wrap .NET objects and the compiled script cache, so extra contexts
+// are much cheaper than extra isolates.
+//
+// Only one thread can use an isolate at a time, so its contexts cannot run
+// in parallel.  TerminateExecution() on any of them stops whichever one is
+// running.
+//
+// A JavascriptContext constructed on its own gets a private isolate, which
+// it disposes along with itself.
+//
+// A script that runs the heap out of memory is terminated with a
+// JavascriptOutOfMemoryException, rather than v8 aborting the process.  The
+// isolate is unusable after that.
+//
+// The heap size is reported to the CLR as memory pressure, so an isolate
+// that is abandoned without being disposed gets finalized in reasonable
+// time, along with its contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptIsolate: public System::IDisposable
+{
+	////////////////////////////////////////////////////////////
+	// Constructor
+	////////////////////////////////////////////////////////////
+public:
+
+	JavascriptIsolate();
+
+	// Contexts start from the state captured in the snapshot.
+	JavascriptIsolate(JavascriptSnapshot^ snapshot);
+
+	JavascriptIsolate(JavascriptHeapLimits^ heapLimits);
+
+	// Either may be null.
+	JavascriptIsolate(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits);
+
+	// Disposes any contexts still alive.
+	~JavascriptIsolate();
+
+	!JavascriptIsolate();
+
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	JavascriptContext^ CreateContext();
+
+	property int ContextCount { int get(); }
+
+	// True once a script has reached the heap limit.
+	property bool IsOutOfMemory { bool get(); }
+
+	// These wait for any script running on the isolate to finish.
+	JavascriptHeapStatistics^ GetHeapStatistics();
+
+	cli::array<JavascriptHeapSpaceStatistics^>^ GetHeapSpaceStatistics();
+
+	// Taken whenever a thread finishes using the isolate, at most every
+	// SampleIntervalMilliseconds, so reading it never waits.
+	property JavascriptHeapStatistics^ LastHeapStatistics { JavascriptHeapStatistics^ get() { return mLastHeapStatistics; } }
+
+	// Sums LastHeapStatistics over every isolate not yet disposed.  Cheap
+	// enough to call every second or so.
+	static JavascriptHeapStatistics^ GetTotalHeapStatistics();
+
+	literal int SampleIntervalMilliseconds = 100;
+
+	// Gives v8 up to iBudget to do the idle-time work it has queued, such
+	// as incremental marking.  Requires JavascriptPlatform::IdleTasksEnabled.
+	void RunIdleTasks(System::TimeSpan iBudget);
+
+	// Bytes sitting in the ArrayBuffer free lists shared by all isolates.
+	property static long long ArrayBufferPoolMemory { long long get(); }
+
+	// ArrayBuffer allocations served from the free lists.
+	property static long long ArrayBufferPoolHits { long long get(); }
+
+	// ArrayBuffer allocations small enough to pool that still had to go to
+	// the CRT heap.
+	property static long long ArrayBufferPoolMisses { long long get(); }
+
+	////////////////////////////////////////////////////////////
+	// Internal methods
+	////////////////////////////////////////////////////////////
+internal:
+
+	v8::Isolate *GetIsolate() { return mIsolate; }
+
+	// Must be called with the isolate locked.
+	v8::Local<v8::ObjectTemplate> GetObjectWrapperTemplate();
+
+	// Must be called with the isolate locked.  Falls back on the generic
+	// template for types that can't have one of their own.
+	v8::Local<v8::ObjectTemplate> GetObjectWrapperTemplate(System::Type^ iType);
+
+	// Must be called with the isolate locked.  The template for iType's
+	// methods called iName, for objects that use the generic template.
+	v8::Local<v8::FunctionTemplate> GetMethodTemplate(System::Type^ iType, System::String^ iName);
+
+	// Must be called with the isolate locked.  An ArrayBuffer over iArray's
+	// own memory, which stays pinned until v8 collects the buffer or we are
+	// disposed.  iArray must have a primitive element type.
+	v8::Local<v8::ArrayBuffer> NewPinnedArrayBuffer(System::Array^ iArray);
+
+	// Must only be used with the isolate locked.
+	CompiledScriptCache^ GetCompiledScripts() { return mCompiledScripts; }
+
+	void AddContext(JavascriptContext^ iContext);
+
+	void RemoveContext(JavascriptContext^ iContext);
+
+	// Scripts compiled in any of our contexts, which live until they are
+	// disposed or we are.
+	void AddScript(JavascriptScript^ iScript);
+
+	void RemoveScript(JavascriptScript^ iScript);
+
+	// Must be called with the isolate locked.
+	void SampleHeapStatistics();
+
+	// Bracket each time a thread locks the isolate to run scripts.
+	void BeginUse();
+
+	void EndUse();
+
+	// Gives v8 up to iBudgetSeconds of idle-time garbage collection, if
+	// nobody has used the isolate for iDelay and it has not already done
+	// all it wanted to since.  Returns true if it did any.
+	bool CollectIfIdle(System::TimeSpan iDelay, double iBudgetSeconds);
+
+	// A full collection if the isolate is idle, otherwise a request for
+	// one the next time the running script can be interrupted.
+	void NotifyLowMemory();
+
+	// Isolates not yet disposed or finalized.
+	static cli::array<JavascriptIsolate^>^ GetIsolates();
+
+	// Likewise, but counting those the GC has let go of and whose
+	// finalizers have yet to run.
+	static int GetUnfinalizedCount();
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	void Initialise(JavascriptSnapshot^ snapshot, JavascriptHeapLimits^ heapLimits);
+
+	// Must be called with the isolate locked.
+	JavascriptHeapStatistics^ ReadHeapStatistics();
+
+	// Must be called with the isolate locked.  Also brings the memory
+	// pressure we have reported to the CLR into line with the sample.
+	void TakeHeapSample();
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	v8::Isolate *mIsolate;
+
+	JavascriptArrayBufferAllocator *mAllocator;
+
+	// Shared with our NearHeapLimitCallback.
+	HeapLimitState *mHeapLimitState;
+
+	// Property names seen by our interceptors.  Only used with the isolate
+	// locked.
+	JavascriptNameTable *mNames;
+
+	// Keeps the snapshot blob alive for as long as the isolate may read it.
+	// Null if we started from v8's own snapshot.
+	JavascriptSnapshot^ mSnapshot;
+
+	// Avoids us recreating this too often.  Its instance template is the
+	// generic template.
+	v8::Persistent<v8::FunctionTemplate> *mObjectWrapperTemplate;
+
+	// Persistent<FunctionTemplate>* for each type wrapped so far, or zero
+	// for types that use mObjectWrapperTemplate.  Only used with the
+	// isolate locked.
+	System::Collections::Generic::Dictionary<System::Type^, System::IntPtr> ^mTypeTemplates;
+
+	// GenericMethod* for each (type, method name) looked up through the
+	// generic template.  Only used with the isolate locked.
+	System::Collections::Generic::Dictionary<GenericMethodKey, System::IntPtr> ^mMethodTemplates;
+
+	// PinnedBuffer* for each array made by NewPinnedArrayBuffer() that v8
+	// has yet to collect.  Only used with the isolate locked.
+	System::Collections::Generic::HashSet<System::IntPtr> ^mPinnedBuffers;
+
+	// Recently Run() scripts, shared by all our contexts.
+	CompiledScriptCache ^mCompiledScripts;
+
+	// Contexts not yet disposed.  Locked, because contexts may be disposed
+	// from any thread.
+	System::Collections::Generic::List<JavascriptContext^> ^mContexts;
+
+	// Scripts not yet disposed.  Locked, for the same reason.
+	System::Collections::Generic::HashSet<JavascriptScript^> ^mScripts;
+
+	JavascriptHeapStatistics ^mLastHeapStatistics;
+
+	// Stopwatch timestamp of mLastHeapStatistics.
+	long long mLastSampleTimestamp;
+
+	// Bytes added with GC::AddMemoryPressure() and not yet removed.
+	long long mMemoryPressure;
+
+	// True while a thread holds the isolate to run scripts.
+	bool mInUse;
+
+	// Stopwatch timestamp of the last EndUse().
+	long long mLastUseTimestamp;
+
+	// Set when v8 says it has no more idle-time work, and cleared by the
+	// next use.
+	bool mIdleCollectionDone;
+
+	// Held by JavascriptMemoryManager's thread while it uses the isolate,
+	// and by disposal, so that the two don't overlap.
+	System::Object ^mCollectionLock;
+
+	// Our entry in sIsolates.
+	System::WeakReference ^mSelf;
+
+	// Isolates not yet disposed, for GetTotalHeapStatistics() and
+	// JavascriptMemoryManager.  Weak, so that abandoned isolates can be
+	// finalized.  Locked.
+	static System::Collections::Generic::List<System::WeakReference^> ^sIsolates = gcnew System::Collections::Generic::List<System::WeakReference^>();
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
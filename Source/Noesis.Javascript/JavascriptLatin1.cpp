@@ -0,0 +1,68 @@
+#include "JavascriptLatin1.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define LATIN1_SSE2
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+
+bool
+NarrowToLatin1(const uint16_t *iSource, uint8_t *oDest, size_t iLength)
+{
+	size_t i = 0;
+#ifdef LATIN1_SSE2
+	const __m128i high = _mm_set1_epi16((short)0xFF00);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= iLength; i += 16)
+	{
+		__m128i first = _mm_loadu_si128((const __m128i *)(iSource + i));
+		__m128i second = _mm_loadu_si128((const __m128i *)(iSource + i + 8));
+		__m128i above = _mm_and_si128(_mm_or_si128(first, second), high);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi16(above, zero)) != 0xFFFF)
+			return false;
+		// Every lane is at most 0xFF, so the saturating pack just narrows.
+		_mm_storeu_si128((__m128i *)(oDest + i), _mm_packus_epi16(first, second));
+	}
+#endif
+	for (; i < iLength; i++)
+	{
+		if (iSource[i] > 0xFF)
+			return false;
+		oDest[i] = (uint8_t)iSource[i];
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+WidenFromLatin1(const uint8_t *iSource, uint16_t *oDest, size_t iLength)
+{
+	size_t i = 0;
+#ifdef LATIN1_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= iLength; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(iSource + i));
+		_mm_storeu_si128((__m128i *)(oDest + i), _mm_unpacklo_epi8(bytes, zero));
+		_mm_storeu_si128((__m128i *)(oDest + i + 8), _mm_unpackhi_epi8(bytes, zero));
+	}
+#endif
+	for (; i < iLength; i++)
+		oDest[i] = iSource[i];
+}
+
+#pragma managed(pop)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
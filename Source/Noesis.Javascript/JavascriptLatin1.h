@@ -0,0 +1,34 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Latin-1 conversions
+//
+// v8 keeps strings whose characters all fit in a byte as one-byte strings.
+// These move characters between that form and the UTF-16 that .NET uses,
+// sixteen at a time where SSE2 is available.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+
+// Copies iLength characters into oDest, one byte each.  Returns false,
+// leaving oDest partly written, if any of them is above U+00FF.
+bool NarrowToLatin1(const uint16_t *iSource, uint8_t *oDest, size_t iLength);
+
+void WidenFromLatin1(const uint8_t *iSource, uint16_t *oDest, size_t iLength);
+
+#pragma managed(pop)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,372 @@
+#include "JavascriptMemberCache.h"
+#include "SystemInterop.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace System::Linq::Expressions;
+using namespace System::Reflection;
+
+typedef System::Func<System::Object^, cli::array<System::Object^>^, System::Object^> InvokerDelegate;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledMethod::CompiledMethod(MethodInfo^ iMethod)
+{
+	mMethod = iMethod;
+	cli::array<ParameterInfo^>^ parameters = iMethod->GetParameters();
+	mParameterTypes = gcnew cli::array<System::Type^>(parameters->Length);
+	mDefaults = gcnew cli::array<System::Object^>(parameters->Length);
+	for (int i = 0; i < parameters->Length; i++)
+	{
+		System::Type^ type = parameters[i]->ParameterType;
+		mParameterTypes[i] = type;
+		if (type->IsValueType && System::Nullable::GetUnderlyingType(type) == nullptr)
+			mDefaults[i] = System::Activator::CreateInstance(type);
+	}
+	mInvoker = Compile(iMethod);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds (target, args) => (object)((T)target).Method((P0)args[0], ...).
+InvokerDelegate^
+CompiledMethod::Compile(MethodInfo^ iMethod)
+{
+	// Calling through a copy of a struct would lose any changes the method
+	// makes, whereas MethodInfo::Invoke() works on the boxed original.
+	if (iMethod->ContainsGenericParameters || iMethod->DeclaringType->IsValueType)
+		return nullptr;
+	cli::array<ParameterInfo^>^ parameters = iMethod->GetParameters();
+	for each (ParameterInfo^ parameter in parameters)
+		if (parameter->ParameterType->IsByRef || parameter->ParameterType->IsPointer)
+			return nullptr;
+
+	try
+	{
+		ParameterExpression^ target = Expression::Parameter(System::Object::typeid, "target");
+		ParameterExpression^ args = Expression::Parameter(cli::array<System::Object^>::typeid, "args");
+		cli::array<Expression^>^ arguments = gcnew cli::array<Expression^>(parameters->Length);
+		for (int i = 0; i < parameters->Length; i++)
+			arguments[i] = Expression::Convert(Expression::ArrayIndex(args, Expression::Constant(i)), parameters[i]->ParameterType);
+
+		Expression^ instance = iMethod->IsStatic ? nullptr : Expression::Convert(target, iMethod->DeclaringType);
+		Expression^ call = Expression::Call(instance, iMethod, arguments);
+		Expression^ body;
+		if (iMethod->ReturnType == System::Void::typeid)
+			body = Expression::Block(call, Expression::Constant(nullptr));
+		else
+			body = Expression::Convert(call, System::Object::typeid);
+		return Expression::Lambda<InvokerDelegate^>(body, target, args)->Compile();
+	}
+	catch (System::Exception^)
+	{
+		// Something we didn't think of.  Reflection will still work.
+		return nullptr;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<System::Object^>^
+CompiledMethod::ConvertArguments(cli::array<System::Object^>^ iSuppliedArguments)
+{
+	cli::array<System::Object^>^ arguments = gcnew cli::array<System::Object^>(mParameterTypes->Length);  // trailing parameters will be null
+	for (int p = 0; p < iSuppliedArguments->Length; p++)
+	{
+		System::Object^ supplied = iSuppliedArguments[p];
+		if (supplied == nullptr)
+			continue;
+		if (supplied->GetType() == mParameterTypes[p])
+			arguments[p] = supplied;
+		else
+		{
+			arguments[p] = SystemInterop::ConvertToType(supplied, mParameterTypes[p]);
+			if (arguments[p] == nullptr)
+				return nullptr;
+		}
+	}
+	return arguments;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+CompiledMethod::Invoke(System::Object^ iTarget, cli::array<System::Object^>^ iArguments)
+{
+	if (mInvoker == nullptr)
+		return mMethod->Invoke(iTarget, iArguments);
+
+	// Unboxing a null would throw.
+	for (int i = 0; i < iArguments->Length; i++)
+		if (iArguments[i] == nullptr)
+			iArguments[i] = mDefaults[i];
+	try
+	{
+		return mInvoker(iTarget, iArguments);
+	}
+	catch (System::Exception^ exception)
+	{
+		throw gcnew TargetInvocationException(exception);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+OverloadKey::OverloadKey(System::String^ iName, cli::array<System::Object^>^ iArguments)
+{
+	mName = iName;
+	mTypes = gcnew cli::array<System::Type^>(iArguments->Length);
+	int hash = iName->GetHashCode();
+	for (int i = 0; i < iArguments->Length; i++)
+	{
+		if (iArguments[i] != nullptr)
+			mTypes[i] = iArguments[i]->GetType();
+		hash = hash * 31 + (mTypes[i] == nullptr ? 0 : mTypes[i]->GetHashCode());
+	}
+	mHashCode = hash;
+}
+
+bool
+OverloadKey::Equals(OverloadKey^ iOther)
+{
+	if (iOther == nullptr || iOther->mHashCode != mHashCode || iOther->mTypes->Length != mTypes->Length)
+		return false;
+	for (int i = 0; i < mTypes->Length; i++)
+		if (iOther->mTypes[i] != mTypes[i])
+			return false;
+	return System::String::Equals(iOther->mName, mName);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CachedMember::CachedMember(System::Type^ iType, System::String^ iName)
+{
+	mName = iName;
+	cli::array<MemberInfo^>^ members = iType->GetMember(iName);
+	mIsMethod = members->Length > 0 && members[0]->MemberType == MemberTypes::Method;
+	try
+	{
+		mProperty = iType->GetProperty(iName);
+	}
+	catch (AmbiguousMatchException^)
+	{
+		// A property hidden with 'new'.  We can't tell which one is meant.
+		return;
+	}
+	if (mProperty == nullptr || mProperty->GetIndexParameters()->Length > 0)
+		return;
+
+	System::Type^ type = mProperty->PropertyType;
+	if (type->IsValueType && System::Nullable::GetUnderlyingType(type) == nullptr)
+		mDefault = System::Activator::CreateInstance(type);
+	mGetter = CompileGetter(mProperty);
+	mSetter = CompileSetter(mProperty);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds target => (object)((T)target).Property.
+System::Func<System::Object^, System::Object^>^
+CachedMember::CompileGetter(PropertyInfo^ iProperty)
+{
+	MethodInfo^ getter = iProperty->GetGetMethod(true);
+	if (getter == nullptr)
+		return nullptr;
+	try
+	{
+		ParameterExpression^ target = Expression::Parameter(System::Object::typeid, "target");
+		Expression^ instance = getter->IsStatic ? nullptr : Expression::Convert(target, iProperty->DeclaringType);
+		Expression^ body = Expression::Convert(Expression::Call(instance, getter), System::Object::typeid);
+		return Expression::Lambda<System::Func<System::Object^, System::Object^>^>(body, target)->Compile();
+	}
+	catch (System::Exception^)
+	{
+		return nullptr;
+	}
+}
+
+// Builds (target, value) => ((T)target).Property = (P)value.
+System::Action<System::Object^, System::Object^>^
+CachedMember::CompileSetter(PropertyInfo^ iProperty)
+{
+	// Setting a property on an unboxed copy of a struct would be lost.
+	MethodInfo^ setter = iProperty->GetSetMethod(true);
+	if (setter == nullptr || iProperty->DeclaringType->IsValueType)
+		return nullptr;
+	try
+	{
+		ParameterExpression^ target = Expression::Parameter(System::Object::typeid, "target");
+		ParameterExpression^ value = Expression::Parameter(System::Object::typeid, "value");
+		Expression^ instance = setter->IsStatic ? nullptr : Expression::Convert(target, iProperty->DeclaringType);
+		Expression^ body = Expression::Call(instance, setter, Expression::Convert(value, iProperty->PropertyType));
+		return Expression::Lambda<System::Action<System::Object^, System::Object^>^>(body, target, value)->Compile();
+	}
+	catch (System::Exception^)
+	{
+		return nullptr;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+CachedMember::GetValue(System::Object^ iTarget)
+{
+	if (mGetter == nullptr)
+		return mProperty->GetValue(iTarget, nullptr);
+	try
+	{
+		return mGetter(iTarget);
+	}
+	catch (System::Exception^ exception)
+	{
+		throw gcnew TargetInvocationException(exception);
+	}
+}
+
+void
+CachedMember::SetValue(System::Object^ iTarget, System::Object^ iValue)
+{
+	if (mSetter == nullptr)
+	{
+		mProperty->SetValue(iTarget, iValue, nullptr);
+		return;
+	}
+	try
+	{
+		mSetter(iTarget, iValue == nullptr ? mDefault : iValue);
+	}
+	catch (System::Exception^ exception)
+	{
+		throw gcnew TargetInvocationException(exception);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptMemberCache::JavascriptMemberCache(System::Type^ iType)
+{
+	mType = iType;
+	mOverloads = gcnew System::Collections::Concurrent::ConcurrentDictionary<OverloadKey^, CompiledMethod^>();
+	mMethods = gcnew System::Collections::Concurrent::ConcurrentDictionary<MethodInfo^, CompiledMethod^>();
+	mMembers = gcnew System::Collections::Concurrent::ConcurrentDictionary<System::String^, CachedMember^>();
+
+	// An ambiguous indexer is as good as none to us.
+	try
+	{
+		mStringIndexer = iType->GetProperty("Item", System::Object::typeid, gcnew cli::array<System::Type^> { System::String::typeid });
+	}
+	catch (AmbiguousMatchException^)
+	{
+	}
+	try
+	{
+		mIntegerIndexer = iType->GetProperty("Item", gcnew cli::array<System::Type^> { int::typeid });
+		if (mIntegerIndexer != nullptr && mIntegerIndexer->GetIndexParameters()->Length != 1)
+			mIntegerIndexer = nullptr;
+	}
+	catch (AmbiguousMatchException^)
+	{
+	}
+}
+
+JavascriptMemberCache^
+JavascriptMemberCache::Get(System::Type^ iType)
+{
+	JavascriptMemberCache^ cache;
+	if (!sCaches->TryGetValue(iType, cache))
+		cache = sCaches->GetOrAdd(iType, gcnew JavascriptMemberCache(iType));
+	return cache;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledMethod^
+JavascriptMemberCache::GetOverload(OverloadKey^ iKey)
+{
+	CompiledMethod^ method;
+	mOverloads->TryGetValue(iKey, method);
+	return method;
+}
+
+void
+JavascriptMemberCache::AddOverload(OverloadKey^ iKey, CompiledMethod^ iMethod)
+{
+	if (mOverloadCount < MaxOverloads && mOverloads->TryAdd(iKey, iMethod))
+		System::Threading::Interlocked::Increment(mOverloadCount);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledMethod^
+JavascriptMemberCache::GetCompiledMethod(MethodInfo^ iMethod)
+{
+	CompiledMethod^ method;
+	if (!mMethods->TryGetValue(iMethod, method))
+		method = mMethods->GetOrAdd(iMethod, gcnew CompiledMethod(iMethod));
+	return method;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CachedMember^
+JavascriptMemberCache::GetMember(System::String^ iName)
+{
+	CachedMember^ member;
+	if (mMembers->TryGetValue(iName, member))
+		return member;
+	member = gcnew CachedMember(mType, iName);
+	if (mMemberCount < MaxMembers && mMembers->TryAdd(iName, member))
+		System::Threading::Interlocked::Increment(mMemberCount);
+	return member;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Two threads may both build these, but they build the same thing.
+cli::array<CachedMember^>^
+JavascriptMemberCache::Properties::get()
+{
+	if (mProperties == nullptr)
+	{
+		System::Collections::Generic::List<CachedMember^>^ properties = gcnew System::Collections::Generic::List<CachedMember^>();
+		System::Collections::Generic::HashSet<System::String^>^ seen = gcnew System::Collections::Generic::HashSet<System::String^>();
+		for each (PropertyInfo^ property in mType->GetProperties(BindingFlags::Public | BindingFlags::Instance | BindingFlags::Static))
+		{
+			if (property->GetIndexParameters()->Length > 0 || !seen->Add(property->Name))
+				continue;
+			CachedMember^ member = GetMember(property->Name);
+			if (!member->IsMethod && member->Property != nullptr && member->Property->GetIndexParameters()->Length == 0)
+				properties->Add(member);
+		}
+		mProperties = properties->ToArray();
+	}
+	return mProperties;
+}
+
+cli::array<System::String^>^
+JavascriptMemberCache::Methods::get()
+{
+	if (mMethodNames == nullptr)
+	{
+		System::Collections::Generic::List<System::String^>^ names = gcnew System::Collections::Generic::List<System::String^>();
+		System::Collections::Generic::HashSet<System::String^>^ seen = gcnew System::Collections::Generic::HashSet<System::String^>();
+		for each (MethodInfo^ method in mType->GetMethods(BindingFlags::Public | BindingFlags::Instance | BindingFlags::Static))
+		{
+			if (seen->Add(method->Name) && GetMember(method->Name)->IsMethod)
+				names->Add(method->Name);
+		}
+		mMethodNames = names->ToArray();
+	}
+	return mMethodNames;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,191 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// CompiledMethod
+//
+// A method chosen by JavascriptInterop::Invoker(), compiled into a delegate
+// so that calling it needs no reflection.  Methods the compiler can't
+// handle, such as those with ref parameters, are still called through
+// MethodInfo::Invoke().
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class CompiledMethod
+{
+public:
+	CompiledMethod(System::Reflection::MethodInfo^ iMethod);
+
+	property System::Reflection::MethodInfo^ Method { System::Reflection::MethodInfo^ get() { return mMethod; } }
+
+	// Converts arguments from JavaScript to our parameter types, padding
+	// with nulls.  Returns null if one of them won't convert.
+	cli::array<System::Object^>^ ConvertArguments(cli::array<System::Object^>^ iSuppliedArguments);
+
+	// Exceptions thrown by the method come out wrapped in a
+	// TargetInvocationException, as they would from MethodInfo::Invoke().
+	System::Object^ Invoke(System::Object^ iTarget, cli::array<System::Object^>^ iArguments);
+
+private:
+	static System::Func<System::Object^, cli::array<System::Object^>^, System::Object^>^ Compile(System::Reflection::MethodInfo^ iMethod);
+
+	System::Reflection::MethodInfo^ mMethod;
+
+	cli::array<System::Type^>^ mParameterTypes;
+
+	// What MethodInfo::Invoke() passes for a null, for each parameter.
+	cli::array<System::Object^>^ mDefaults;
+
+	// Null if the method could not be compiled.
+	System::Func<System::Object^, cli::array<System::Object^>^, System::Object^>^ mInvoker;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// OverloadKey
+//
+// A method name plus the .NET types of the arguments JavaScript supplied,
+// which is everything overload resolution looks at bar the argument values.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class OverloadKey: public System::IEquatable<OverloadKey^>
+{
+public:
+	OverloadKey(System::String^ iName, cli::array<System::Object^>^ iArguments);
+
+	virtual bool Equals(OverloadKey^ iOther);
+
+	virtual bool Equals(System::Object^ iOther) override { return Equals(dynamic_cast<OverloadKey^>(iOther)); }
+
+	virtual int GetHashCode() override { return mHashCode; }
+
+private:
+	System::String^ mName;
+
+	// Null for null arguments.
+	cli::array<System::Type^>^ mTypes;
+
+	int mHashCode;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// CachedMember
+//
+// What a name means on a type: a method, a property with compiled
+// accessors, or nothing at all.  Indexed properties and setters on structs
+// are left to reflection.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class CachedMember
+{
+public:
+	CachedMember(System::Type^ iType, System::String^ iName);
+
+	property System::String^ Name { System::String^ get() { return mName; } }
+
+	// As opposed to a property.
+	property bool IsMethod { bool get() { return mIsMethod; } }
+
+	// Null if there is no public property by this name, or more than one.
+	property System::Reflection::PropertyInfo^ Property { System::Reflection::PropertyInfo^ get() { return mProperty; } }
+
+	// The accessors throw TargetInvocationException, like reflection.
+	System::Object^ GetValue(System::Object^ iTarget);
+
+	void SetValue(System::Object^ iTarget, System::Object^ iValue);
+
+private:
+	static System::Func<System::Object^, System::Object^>^ CompileGetter(System::Reflection::PropertyInfo^ iProperty);
+
+	static System::Action<System::Object^, System::Object^>^ CompileSetter(System::Reflection::PropertyInfo^ iProperty);
+
+	System::String^ mName;
+
+	bool mIsMethod;
+
+	System::Reflection::PropertyInfo^ mProperty;
+
+	// Null if not compiled.
+	System::Func<System::Object^, System::Object^>^ mGetter;
+
+	System::Action<System::Object^, System::Object^>^ mSetter;
+
+	// What reflection would store for a null.
+	System::Object^ mDefault;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptMemberCache
+//
+// What we have learnt about one .NET type's members by reflection, so that
+// we only need to learn it once.  Shared by all threads and contexts.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class JavascriptMemberCache
+{
+public:
+	static JavascriptMemberCache^ Get(System::Type^ iType);
+
+	// Null if we haven't resolved this call before.
+	CompiledMethod^ GetOverload(OverloadKey^ iKey);
+
+	void AddOverload(OverloadKey^ iKey, CompiledMethod^ iMethod);
+
+	// Methods are compiled once, however many argument signatures resolve
+	// to them.
+	CompiledMethod^ GetCompiledMethod(System::Reflection::MethodInfo^ iMethod);
+
+	// Names that turn out not to be members are remembered too, so that
+	// probing a wrapped object for them stays cheap.
+	CachedMember^ GetMember(System::String^ iName);
+
+	// this[string], or null.
+	property System::Reflection::PropertyInfo^ StringIndexer { System::Reflection::PropertyInfo^ get() { return mStringIndexer; } }
+
+	// this[int], or null.
+	property System::Reflection::PropertyInfo^ IntegerIndexer { System::Reflection::PropertyInfo^ get() { return mIntegerIndexer; } }
+
+	// Every name that GetMember() would call a property, for building
+	// templates.  Indexers are not included.
+	property cli::array<CachedMember^>^ Properties { cli::array<CachedMember^>^ get(); }
+
+	// Likewise every name that GetMember() would call a method.
+	property cli::array<System::String^>^ Methods { cli::array<System::String^>^ get(); }
+
+	// Scripts can make up any number of property names.
+	literal int MaxMembers = 1024;
+
+	// A type can only have so many overloads, but callers can come up with
+	// endless combinations of argument types.
+	literal int MaxOverloads = 256;
+
+private:
+	JavascriptMemberCache(System::Type^ iType);
+
+	System::Type^ mType;
+
+	System::Collections::Concurrent::ConcurrentDictionary<OverloadKey^, CompiledMethod^> ^mOverloads;
+
+	// ConcurrentDictionary::Count takes every lock, so we keep our own.
+	int mOverloadCount;
+
+	System::Collections::Concurrent::ConcurrentDictionary<System::String^, CachedMember^> ^mMembers;
+
+	int mMemberCount;
+
+	System::Reflection::PropertyInfo^ mStringIndexer;
+
+	System::Reflection::PropertyInfo^ mIntegerIndexer;
+
+	// Built on first use.
+	cli::array<CachedMember^>^ mProperties;
+
+	cli::array<System::String^>^ mMethodNames;
+
+	System::Collections::Concurrent::ConcurrentDictionary<System::Reflection::MethodInfo^, CompiledMethod^> ^mMethods;
+
+	static System::Collections::Concurrent::ConcurrentDictionary<System::Type^, JavascriptMemberCache^> ^sCaches = gcnew System::Collections::Concurrent::ConcurrentDictionary<System::Type^, JavascriptMemberCache^>();
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
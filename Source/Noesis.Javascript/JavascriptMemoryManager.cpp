@@ -0,0 +1,165 @@
+#include <windows.h>
+#include <msclr\lock.h>
+
+#include "JavascriptMemoryManager.h"
+#include "JavascriptIsolate.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace msclr;
+using namespace System::Threading;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static JavascriptMemoryManager::JavascriptMemoryManager()
+{
+	sLock = gcnew System::Object();
+	sIdleCollectionDelay = System::TimeSpan::FromSeconds(1);
+	sIdleCollectionBudget = System::TimeSpan::FromMilliseconds(10);
+	sHighMemoryLoadPercent = 90;
+	sMemoryPressureEnabled = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::IdleCollectionEnabled::set(bool value)
+{
+	lock l(sLock);
+	sIdleCollectionEnabled = value;
+	Wake();
+}
+
+void
+JavascriptMemoryManager::IdleCollectionDelay::set(System::TimeSpan value)
+{
+	if (value < System::TimeSpan::Zero)
+		throw gcnew System::ArgumentOutOfRangeException("value");
+	sIdleCollectionDelay = value;
+}
+
+void
+JavascriptMemoryManager::IdleCollectionBudget::set(System::TimeSpan value)
+{
+	if (value <= System::TimeSpan::Zero)
+		throw gcnew System::ArgumentOutOfRangeException("value");
+	sIdleCollectionBudget = value;
+}
+
+void
+JavascriptMemoryManager::LowMemoryNotificationsEnabled::set(bool value)
+{
+	lock l(sLock);
+	sLowMemoryNotificationsEnabled = value;
+	sMemoryLoadHigh = false;
+	Wake();
+}
+
+void
+JavascriptMemoryManager::HighMemoryLoadPercent::set(int value)
+{
+	if (value <= 0 || value > 100)
+		throw gcnew System::ArgumentOutOfRangeException("value");
+	sHighMemoryLoadPercent = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::NotifyLowMemory()
+{
+	Interlocked::Increment(sLowMemoryNotifications);
+	for each (JavascriptIsolate^ isolate in JavascriptIsolate::GetIsolates())
+		isolate->NotifyLowMemory();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::Wake()
+{
+	if (sThread == nullptr)
+	{
+		if (!sIdleCollectionEnabled && !sLowMemoryNotificationsEnabled)
+			return;
+		sThread = gcnew Thread(gcnew ThreadStart(&JavascriptMemoryManager::Manage));
+		sThread->IsBackground = true;
+		sThread->Name = "Javascript memory manager";
+		sThread->Start();
+	}
+	Monitor::Pulse(sLock);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::Manage()
+{
+	lock l(sLock);
+	while (true)
+	{
+		if (!sIdleCollectionEnabled && !sLowMemoryNotificationsEnabled)
+			Monitor::Wait(sLock);
+		else
+			Monitor::Wait(sLock, PollMilliseconds);
+
+		bool collect = sIdleCollectionEnabled;
+		bool check = sLowMemoryNotificationsEnabled;
+
+		// Collecting can wait on v8 locks, and the setters shouldn't.
+		l.release();
+		try
+		{
+			if (check)
+				CheckMemoryLoad();
+			if (collect)
+				CollectIdleIsolates();
+		}
+		catch (System::Exception^)
+		{
+			// Isolates can be disposed under our feet.  Nothing here is
+			// important enough to take the thread down.
+		}
+		l.acquire();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::CheckMemoryLoad()
+{
+	// This is the figure the CLR's garbage collector goes by too.
+	MEMORYSTATUSEX status;
+	status.dwLength = sizeof(status);
+	if (!GlobalMemoryStatusEx(&status))
+		return;
+	bool high = (int)status.dwMemoryLoad >= sHighMemoryLoadPercent;
+	if (high && !sMemoryLoadHigh)
+		NotifyLowMemory();
+	sMemoryLoadHigh = high;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptMemoryManager::CollectIdleIsolates()
+{
+	System::TimeSpan delay = sIdleCollectionDelay;
+	double budget = sIdleCollectionBudget.TotalSeconds;
+	for each (JavascriptIsolate^ isolate in JavascriptIsolate::GetIsolates())
+	{
+		if (isolate->CollectIfIdle(delay, budget))
+			Interlocked::Increment(sIdleCollections);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,142 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptMemoryManager
+//
+// Process-wide garbage collection policy for our isolates.  v8 only collects
+// when a script allocates, so an isolate that has gone quiet holds on to
+// its garbage indefinitely.  When enabled, one background thread gives
+// quiet isolates idle-time collections, and asks every isolate for a full
+// collection when the machine runs short of memory.
+//
+// The thread takes an isolate's lock to collect, so a script started at
+// that moment waits up to IdleCollectionBudget for it.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptMemoryManager abstract sealed
+{
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	// Off by default.
+	property static bool IdleCollectionEnabled
+	{
+		bool get() { return sIdleCollectionEnabled; }
+		void set(bool value);
+	}
+
+	// How long an isolate must go unused before it is collected.
+	property static System::TimeSpan IdleCollectionDelay
+	{
+		System::TimeSpan get() { return sIdleCollectionDelay; }
+		void set(System::TimeSpan value);
+	}
+
+	// The most time v8 is given per collection.  It does the rest in later
+	// slices, until it reports that it has nothing more to do.
+	property static System::TimeSpan IdleCollectionBudget
+	{
+		System::TimeSpan get() { return sIdleCollectionBudget; }
+		void set(System::TimeSpan value);
+	}
+
+	// Off by default.  Calls NotifyLowMemory() each time the machine's
+	// memory load rises to HighMemoryLoadPercent.
+	property static bool LowMemoryNotificationsEnabled
+	{
+		bool get() { return sLowMemoryNotificationsEnabled; }
+		void set(bool value);
+	}
+
+	// The CLR's own garbage collector becomes aggressive at 90%.
+	property static int HighMemoryLoadPercent
+	{
+		int get() { return sHighMemoryLoadPercent; }
+		void set(int value);
+	}
+
+	// On by default.  Each isolate reports its heap size to the CLR with
+	// GC::AddMemoryPressure(), so that the CLR knows what an abandoned
+	// context is really holding on to.  Takes effect at each isolate's next
+	// heap sample.
+	property static bool MemoryPressureEnabled
+	{
+		bool get() { return sMemoryPressureEnabled; }
+		void set(bool value) { sMemoryPressureEnabled = value; }
+	}
+
+	// The change in an isolate's heap size that is worth telling the CLR about.
+	literal int MemoryPressureGranularity = 1024 * 1024;
+
+	// Asks every isolate for a full collection: immediately if it is idle,
+	// otherwise at the running script's next interrupt check.  For
+	// applications that have their own idea of when memory is short.
+	static void NotifyLowMemory();
+
+	// Idle-time collections made by the background thread.
+	property static long long IdleCollections { long long get() { return System::Threading::Interlocked::Read(sIdleCollections); } }
+
+	// Calls to NotifyLowMemory(), whether from the background thread or not.
+	property static long long LowMemoryNotifications { long long get() { return System::Threading::Interlocked::Read(sLowMemoryNotifications); } }
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	static JavascriptMemoryManager();
+
+	// Wakes the thread, starting it if need be.  Call with sLock held.
+	static void Wake();
+
+	static void Manage();
+
+	static void CheckMemoryLoad();
+
+	static void CollectIdleIsolates();
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	// How often the thread looks around while it has something to do.
+	literal int PollMilliseconds = 100;
+
+	static System::Object^ sLock;
+
+	static System::Threading::Thread^ sThread;
+
+	static bool sIdleCollectionEnabled;
+
+	static System::TimeSpan sIdleCollectionDelay;
+
+	static System::TimeSpan sIdleCollectionBudget;
+
+	static bool sLowMemoryNotificationsEnabled;
+
+	static int sHighMemoryLoadPercent;
+
+	static bool sMemoryPressureEnabled;
+
+	// Whether the memory load was high at the last check, so that we only
+	// notify as it crosses the threshold.
+	static bool sMemoryLoadHigh;
+
+	static long long sIdleCollections, sLowMemoryNotifications;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,59 @@
+#include "JavascriptNameTable.h"
+#include "JavascriptInterop.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace v8;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptNameTable::JavascriptNameTable(v8::Isolate *iIsolate)
+{
+	mIsolate = iIsolate;
+	mIsolate->SetData(DataSlot, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptNameTable::~JavascriptNameTable()
+{
+	for (auto it = mEntries.begin(); it != mEntries.end(); ++it)
+	{
+		it->second->name.Reset();
+		delete it->second;
+	}
+	mEntries.clear();
+	mIsolate->SetData(DataSlot, NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::String^
+JavascriptNameTable::GetName(Local<String> iName)
+{
+	int hash = iName->GetIdentityHash();
+	auto range = mEntries.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+		if (it->second->name == iName)
+			return it->second->value;
+
+	System::String^ name = JavascriptInterop::ConvertStringFromV8(mIsolate, iName);
+	if (mEntries.size() < Capacity)
+	{
+		Entry *entry = new Entry();
+		entry->name.Reset(mIsolate, iName);
+		entry->value = name;
+		mEntries.emplace(hash, entry);
+	}
+	return name;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,65 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+#include <unordered_map>
+#include <gcroot.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptNameTable
+//
+// Remembers the .NET string for each property name our interceptors have
+// been asked about, so that looking up a member does not allocate one on
+// every access.  v8 internalizes property names, so a name is recognised
+// by the identity of its v8 string.
+//
+// One per isolate, stored in its data slot.  Scripts can make up names
+// as they go, so the table stops growing at Capacity; names first seen
+// after that are converted afresh each time.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+class JavascriptNameTable
+{
+public:
+
+	static const size_t Capacity = 4096;
+
+	JavascriptNameTable(v8::Isolate *iIsolate);
+
+	// Must be called with the isolate locked, before it is disposed.
+	~JavascriptNameTable();
+
+	// The table of the isolate, which must be one of ours.
+	static JavascriptNameTable *Get(v8::Isolate *iIsolate)
+	{
+		return (JavascriptNameTable *)iIsolate->GetData(DataSlot);
+	}
+
+	// Must be called with the isolate locked.
+	System::String^ GetName(v8::Local<v8::String> iName);
+
+private:
+
+	static const uint32_t DataSlot = 0;
+
+	struct Entry
+	{
+		v8::Persistent<v8::String> name;
+		gcroot<System::String^> value;
+	};
+
+	v8::Isolate *mIsolate;
+
+	// Keyed by the v8 string's hash.
+	std::unordered_multimap<int, Entry *> mEntries;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
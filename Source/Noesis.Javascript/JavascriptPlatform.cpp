@@ -0,0 +1,166 @@
+#include "libplatform/libplatform.h"
+
+#include "JavascriptPlatform.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace System::Threading;
+using namespace System::Threading::Tasks;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma managed(push, off)
+	v8::Platform *sPlatform = NULL;
+	v8::Platform *sDefaultPlatform = NULL;
+
+	// Forwards everything to libplatform's default platform except worker
+	// tasks, which go to PostWorkerTask().
+	class SchedulerPlatform : public v8::Platform
+	{
+	public:
+		SchedulerPlatform(v8::Platform *inner, int worker_threads) : inner_(inner), worker_threads_(worker_threads) {}
+
+		virtual v8::PageAllocator *GetPageAllocator() { return inner_->GetPageAllocator(); }
+		virtual void OnCriticalMemoryPressure() { inner_->OnCriticalMemoryPressure(); }
+		virtual bool OnCriticalMemoryPressure(size_t length) { return inner_->OnCriticalMemoryPressure(length); }
+		virtual int NumberOfWorkerThreads() { return worker_threads_; }
+		virtual std::shared_ptr<v8::TaskRunner> GetForegroundTaskRunner(v8::Isolate *isolate) { return inner_->GetForegroundTaskRunner(isolate); }
+		virtual void CallOnWorkerThread(std::unique_ptr<v8::Task> task) { PostWorkerTask(task.release(), 0); }
+		virtual void CallDelayedOnWorkerThread(std::unique_ptr<v8::Task> task, double delay_in_seconds) { PostWorkerTask(task.release(), delay_in_seconds); }
+		virtual void CallOnForegroundThread(v8::Isolate *isolate, v8::Task *task) { inner_->CallOnForegroundThread(isolate, task); }
+		virtual void CallDelayedOnForegroundThread(v8::Isolate *isolate, v8::Task *task, double delay_in_seconds) { inner_->CallDelayedOnForegroundThread(isolate, task, delay_in_seconds); }
+		virtual void CallIdleOnForegroundThread(v8::Isolate *isolate, v8::IdleTask *task) { inner_->CallIdleOnForegroundThread(isolate, task); }
+		virtual bool IdleTasksEnabled(v8::Isolate *isolate) { return inner_->IdleTasksEnabled(isolate); }
+		virtual double MonotonicallyIncreasingTime() { return inner_->MonotonicallyIncreasingTime(); }
+		virtual double CurrentClockTimeMillis() { return inner_->CurrentClockTimeMillis(); }
+		virtual StackTracePrinter GetStackTracePrinter() { return inner_->GetStackTracePrinter(); }
+		virtual v8::TracingController *GetTracingController() { return inner_->GetTracingController(); }
+
+	private:
+		v8::Platform *inner_;
+		int worker_threads_;
+	};
+
+	// This has to be unmanaged because of the smart pointers.
+	v8::Platform *NewPlatform(int worker_threads, bool idle_tasks, bool use_scheduler)
+	{
+		v8::platform::IdleTaskSupport idle_task_support = idle_tasks ? v8::platform::IdleTaskSupport::kEnabled : v8::platform::IdleTaskSupport::kDisabled;
+		// libplatform starts its worker pool as soon as it is created, and
+		// takes a size of zero to mean one thread per processor.  With a
+		// scheduler we ask for a single thread, which sits idle because
+		// worker tasks go to the scheduler instead.
+		sDefaultPlatform = v8::platform::NewDefaultPlatform(use_scheduler ? 1 : worker_threads, idle_task_support).release();
+		sPlatform = use_scheduler ? new SchedulerPlatform(sDefaultPlatform, worker_threads) : sDefaultPlatform;
+		return sPlatform;
+	}
+#pragma managed(pop)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptPlatform::WorkerThreadCount::set(int value)
+{
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value");
+	CheckNotInitialised();
+	sWorkerThreadCount = value;
+}
+
+void
+JavascriptPlatform::IdleTasksEnabled::set(bool value)
+{
+	CheckNotInitialised();
+	sIdleTasksEnabled = value;
+}
+
+void
+JavascriptPlatform::WorkerTaskScheduler::set(TaskScheduler^ value)
+{
+	CheckNotInitialised();
+	sWorkerTaskScheduler = value;
+}
+
+bool
+JavascriptPlatform::IsInitialised::get()
+{
+	return sPlatform != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptPlatform::CheckNotInitialised()
+{
+	if (sPlatform != NULL)
+		throw gcnew System::InvalidOperationException("Platform settings must be made before the first JavascriptContext is created.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+v8::Platform *
+JavascriptPlatform::GetPlatform()
+{
+	return sPlatform;
+}
+
+v8::Platform *
+JavascriptPlatform::GetDefaultPlatform()
+{
+	return sDefaultPlatform;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+v8::Platform *
+CreatePlatform()
+{
+	int worker_threads = JavascriptPlatform::WorkerThreadCount;
+	TaskScheduler^ scheduler = JavascriptPlatform::WorkerTaskScheduler;
+	if (scheduler != nullptr && worker_threads == 0)
+		worker_threads = System::Math::Max(1, System::Math::Min(scheduler->MaximumConcurrencyLevel, System::Environment::ProcessorCount));
+	return NewPlatform(worker_threads, JavascriptPlatform::IdleTasksEnabled, scheduler != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ref class WorkerTask
+{
+public:
+	WorkerTask(v8::Task *iTask) : mTask(iTask) {}
+
+	void Run()
+	{
+		mTask->Run();
+		delete mTask;
+		mTask = NULL;
+	}
+
+	void RunAfterDelay(Task^)
+	{
+		Run();
+	}
+
+private:
+	v8::Task *mTask;
+};
+
+void
+PostWorkerTask(v8::Task *iTask, double iDelayInSeconds)
+{
+	WorkerTask^ task = gcnew WorkerTask(iTask);
+	TaskScheduler^ scheduler = JavascriptPlatform::WorkerTaskScheduler;
+	if (iDelayInSeconds <= 0)
+		Task::Factory->StartNew(gcnew System::Action(task, &WorkerTask::Run), CancellationToken::None, TaskCreationOptions::DenyChildAttach, scheduler);
+	else
+		Task::Delay(System::TimeSpan::FromSeconds(iDelayInSeconds))->ContinueWith(gcnew System::Action<Task^>(task, &WorkerTask::RunAfterDelay), CancellationToken::None, TaskContinuationOptions::DenyChildAttach, scheduler);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
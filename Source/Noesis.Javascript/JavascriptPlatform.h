@@ -0,0 +1,100 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptPlatform
+//
+// Settings for the v8::Platform, which runs v8's background work such as
+// concurrent marking and compilation.  They are read once, when the first
+// context or isolate is created, and cannot be changed afterwards.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptPlatform abstract sealed
+{
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	// How many background tasks v8 may expect to run at once.  Zero lets
+	// v8 size its own pool from the number of cores, or uses the
+	// scheduler's MaximumConcurrencyLevel if WorkerTaskScheduler is set.
+	property static int WorkerThreadCount
+	{
+		int get() { return sWorkerThreadCount; }
+		void set(int value);
+	}
+
+	// Lets v8 queue idle-time GC work, which runs when
+	// JavascriptIsolate::RunIdleTasks() is called.
+	property static bool IdleTasksEnabled
+	{
+		bool get() { return sIdleTasksEnabled; }
+		void set(bool value);
+	}
+
+	// If set, v8's background tasks run here instead of on v8's own worker
+	// threads, so that they share the application's CPU budget.  v8
+	// sometimes blocks a script waiting for a background task, so the
+	// scheduler must not be limited to the threads that run scripts.
+	property static System::Threading::Tasks::TaskScheduler^ WorkerTaskScheduler
+	{
+		System::Threading::Tasks::TaskScheduler^ get() { return sWorkerTaskScheduler; }
+		void set(System::Threading::Tasks::TaskScheduler^ value);
+	}
+
+	property static bool IsInitialised { bool get(); }
+
+	////////////////////////////////////////////////////////////
+	// Internal methods
+	////////////////////////////////////////////////////////////
+internal:
+
+	// The platform v8 was given.
+	static v8::Platform *GetPlatform();
+
+	// The libplatform default platform, which may be wrapped by the one v8
+	// was given.  The v8::platform:: helper functions need this one.
+	static v8::Platform *GetDefaultPlatform();
+
+	////////////////////////////////////////////////////////////
+	// Private methods
+	////////////////////////////////////////////////////////////
+private:
+
+	static void CheckNotInitialised();
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	static int sWorkerThreadCount;
+
+	static bool sIdleTasksEnabled;
+
+	static System::Threading::Tasks::TaskScheduler^ sWorkerTaskScheduler;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Standalone functions - can be called from unmanaged code too
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Builds the platform according to JavascriptPlatform's settings.  Called
+// once, by UnmanagedInitialisation().
+v8::Platform *CreatePlatform();
+
+// Takes ownership of iTask and runs it on JavascriptPlatform::WorkerTaskScheduler.
+void PostWorkerTask(v8::Task *iTask, double iDelayInSeconds);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
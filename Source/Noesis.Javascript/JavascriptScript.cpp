@@ -0,0 +1,147 @@
+#include "JavascriptScript.h"
+#include "JavascriptInterop.h"
+#include "JavascriptException.h"
+#include "JavascriptIsolate.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace System::Collections::Generic;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptScript::JavascriptScript(Local<UnboundScript> iScript, JavascriptContext^ iContext)
+{
+	mScript = new Persistent<UnboundScript>(iContext->GetIsolate(), iScript);
+	mContext = iContext;
+	mIsolate = iContext->Isolate;
+
+	mIsolate->AddScript(this);
+}
+
+JavascriptScript::~JavascriptScript()
+{
+	// Once the isolate has gone, so has the script.
+	v8::Isolate *isolate = mIsolate->GetIsolate();
+	if (mScript && isolate != NULL)
+	{
+		v8::Locker v8ThreadLock(isolate);
+		v8::Isolate::Scope isolate_scope(isolate);
+		mIsolate->RemoveScript(this);
+		Release();
+	}
+}
+
+void JavascriptScript::Release()
+{
+	if (mScript)
+	{
+		mScript->Reset();
+		delete mScript;
+		mScript = NULL;
+	}
+}
+
+System::Object^ JavascriptScript::Run()
+{
+	return Run(mContext);
+}
+
+System::Object^ JavascriptScript::Run(JavascriptContext^ iContext)
+{
+	if (iContext == nullptr)
+		throw gcnew System::ArgumentNullException("iContext");
+	if (mScript == nullptr)
+		throw gcnew System::ObjectDisposedException("JavascriptScript");
+	if (iContext->GetIsolate() != mContext->GetIsolate())
+		throw gcnew System::ArgumentException("Scripts can only be run in contexts sharing the isolate they were compiled in.", "iContext");
+	iContext->ThrowIfOutOfMemory();
+
+	JavascriptScope scope(iContext);
+	HandleScope handleScope(iContext->GetIsolate());
+	return iContext->RunScript(Local<UnboundScript>::New(iContext->GetIsolate(), *mScript));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CompiledScriptCache::CompiledScriptCache(int iCapacity)
+{
+	mCapacity = iCapacity;
+	mEntries = gcnew Dictionary<System::String^, LinkedListNode<Entry^>^>();
+	mOrder = gcnew LinkedList<Entry^>();
+}
+
+CompiledScriptCache::~CompiledScriptCache()
+{
+	Clear();
+}
+
+void
+CompiledScriptCache::Capacity::set(int value)
+{
+	if (value < 0)
+		throw gcnew System::ArgumentOutOfRangeException("value");
+	mCapacity = value;
+	while (mOrder->Count > mCapacity)
+		Evict(mOrder->Last);
+}
+
+Local<UnboundScript>
+CompiledScriptCache::Get(v8::Isolate *iIsolate, System::String^ iSourceCode, System::String^ iScriptResourceName)
+{
+	LinkedListNode<Entry^>^ node;
+	if (!mEntries->TryGetValue(iSourceCode, node) || !System::String::Equals(node->Value->resourceName, iScriptResourceName))
+		return Local<UnboundScript>();
+
+	if (node != mOrder->First)
+	{
+		mOrder->Remove(node);
+		mOrder->AddFirst(node);
+	}
+	return Local<UnboundScript>::New(iIsolate, *node->Value->script);
+}
+
+void
+CompiledScriptCache::Add(v8::Isolate *iIsolate, System::String^ iSourceCode, System::String^ iScriptResourceName, Local<UnboundScript> iScript)
+{
+	if (mCapacity == 0)
+		return;
+
+	LinkedListNode<Entry^>^ existing;
+	if (mEntries->TryGetValue(iSourceCode, existing))
+		Evict(existing);
+	while (mOrder->Count >= mCapacity)
+		Evict(mOrder->Last);
+
+	Entry^ entry = gcnew Entry();
+	entry->sourceCode = iSourceCode;
+	entry->resourceName = iScriptResourceName;
+	entry->script = new Persistent<UnboundScript>(iIsolate, iScript);
+	mEntries[iSourceCode] = mOrder->AddFirst(entry);
+}
+
+void
+CompiledScriptCache::Clear()
+{
+	while (mOrder->Count > 0)
+		Evict(mOrder->Last);
+}
+
+void
+CompiledScriptCache::Evict(LinkedListNode<Entry^>^ iNode)
+{
+	mEntries->Remove(iNode->Value->sourceCode);
+	mOrder->Remove(iNode);
+	iNode->Value->script->Reset();
+	delete iNode->Value->script;
+	iNode->Value->script = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,99 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+#include "JavascriptContext.h"
+
+using namespace v8;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptScript
+//
+// A script compiled once by JavascriptContext::Compile(), which can then be
+// run many times without being marshalled or parsed again.  It is bound to
+// a context only when run, so it may be run in any context that shares the
+// isolate it was compiled in.  It belongs to that isolate, and so outlives
+// resets and disposal of the context that compiled it.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptScript
+{
+internal:
+	JavascriptScript(Local<UnboundScript> iScript, JavascriptContext^ iContext);
+
+public:
+	~JavascriptScript();
+
+	// Runs in the context that compiled us.
+	System::Object^ Run();
+
+	System::Object^ Run(JavascriptContext^ iContext);
+
+internal:
+	// Lets go of the compiled script.  Must be called with the isolate
+	// locked, by the isolate once it has forgotten us.
+	void Release();
+
+private:
+	Persistent<UnboundScript>* mScript;
+	JavascriptContext^ mContext;
+	JavascriptIsolate^ mIsolate;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// CompiledScriptCache
+//
+// Bounded least-recently-used map from source code to compiled scripts, so
+// that callers who Run() the same text over and over only compile it once.
+// Must only be used with the owning isolate locked.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class CompiledScriptCache
+{
+public:
+	CompiledScriptCache(int iCapacity);
+
+	~CompiledScriptCache();
+
+	property int Capacity
+	{
+		int get() { return mCapacity; }
+		void set(int value);
+	}
+
+	// Returns an empty handle on a miss.
+	Local<UnboundScript> Get(v8::Isolate *iIsolate, System::String^ iSourceCode, System::String^ iScriptResourceName);
+
+	void Add(v8::Isolate *iIsolate, System::String^ iSourceCode, System::String^ iScriptResourceName, Local<UnboundScript> iScript);
+
+	void Clear();
+
+private:
+	ref struct Entry
+	{
+		System::String^ sourceCode;
+		System::String^ resourceName;  // may be null
+		Persistent<UnboundScript>* script;
+	};
+
+	void Evict(System::Collections::Generic::LinkedListNode<Entry^>^ iNode);
+
+	int mCapacity;
+
+	// Keyed by the source code alone; entries compiled under a different
+	// resource name are treated as misses and replaced.
+	System::Collections::Generic::Dictionary<System::String^, System::Collections::Generic::LinkedListNode<Entry^>^> ^mEntries;
+
+	// Most recently used first.
+	System::Collections::Generic::LinkedList<Entry^> ^mOrder;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,168 @@
+#include "JavascriptSession.h"
+#include "JavascriptFunction.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSession::JavascriptSession(JavascriptContext^ iContext)
+{
+	mContext = iContext;
+	mThreadId = System::Threading::Thread::CurrentThread->ManagedThreadId;
+	mLocker = iContext->Enter(mOldContext);
+	mOuterSession = sCurrentSession;
+	sCurrentSession = this;
+}
+
+// Must not throw, because it is usually called from a using block.
+JavascriptSession::~JavascriptSession()
+{
+	if (mDisposed)
+		return;
+	// The lock can only be released by the thread that holds it.
+	if (System::Threading::Thread::CurrentThread->ManagedThreadId != mThreadId)
+	{
+		System::Diagnostics::Trace::TraceError("A JavascriptSession was disposed on a thread other than the one that began it, and has been left open.");
+		return;
+	}
+	mDisposed = true;
+	LeaveDisposedSessions();
+}
+
+// Only reached if we were never disposed.  The lock belongs to a thread
+// that is gone or has forgotten us, so all we can do is say so.
+JavascriptSession::!JavascriptSession()
+{
+	if (!mDisposed)
+		System::Diagnostics::Trace::TraceError("A JavascriptSession was never disposed, and its isolate is still locked.");
+}
+
+void
+JavascriptSession::LeaveDisposedSessions()
+{
+	while (sCurrentSession != nullptr && sCurrentSession->mDisposed)
+	{
+		JavascriptSession^ session = sCurrentSession;
+		session->mContext->Exit(session->mLocker, session->mOldContext);
+		session->mLocker = NULL;
+		sCurrentSession = session->mOuterSession;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptSession::CheckUsable()
+{
+	if (mDisposed)
+		throw gcnew System::ObjectDisposedException("JavascriptSession");
+	// Locks and context entries belong to threads.
+	if (System::Threading::Thread::CurrentThread->ManagedThreadId != mThreadId)
+		throw gcnew System::InvalidOperationException("A JavascriptSession can only be used on the thread that began it.");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptSession::SetParameter(System::String^ iName, System::Object^ iObject)
+{
+	SetParameter(iName, iObject, SetParameterOptions::None);
+}
+
+void
+JavascriptSession::SetParameter(System::String^ iName, System::Object^ iObject, SetParameterOptions options)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	CheckUsable();
+	mContext->SetParameterInScope(iName, iObject, options);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptSession::GetParameter(System::String^ iName)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	CheckUsable();
+	return mContext->GetParameterInScope(iName);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptSession::SetParameterJson(System::String^ iName, cli::array<System::Byte>^ iUtf8Json)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	if (iUtf8Json == nullptr)
+		throw gcnew System::ArgumentNullException("iUtf8Json");
+	CheckUsable();
+	mContext->SetParameterJsonInScope(iName, iUtf8Json);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<System::Byte>^
+JavascriptSession::GetParameterJson(System::String^ iName)
+{
+	if (iName == nullptr)
+		throw gcnew System::ArgumentNullException("iName");
+	CheckUsable();
+	return mContext->GetParameterJsonInScope(iName);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptSession::Run(System::String^ iScript)
+{
+	return Run(iScript, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+System::Object^
+JavascriptSession::Run(System::String^ iScript, System::String^ iScriptResourceName)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	if (iScriptResourceName == nullptr)
+		throw gcnew System::ArgumentNullException("iScriptResourceName");
+	CheckUsable();
+	return mContext->RunInScope(iScript, iScriptResourceName, System::Threading::Timeout::InfiniteTimeSpan);
+}
+
+System::Object^
+JavascriptSession::Run(System::String^ iScript, System::TimeSpan iTimeout)
+{
+	if (iScript == nullptr)
+		throw gcnew System::ArgumentNullException("iScript");
+	CheckUsable();
+	return mContext->RunInScope(iScript, nullptr, iTimeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+System::Object^
+JavascriptSession::Call(JavascriptFunction^ iFunction, ... cli::array<System::Object^>^ iArgs)
+{
+	if (iFunction == nullptr)
+		throw gcnew System::ArgumentNullException("iFunction");
+	if (iArgs == nullptr)
+		throw gcnew System::ArgumentNullException("iArgs");
+	CheckUsable();
+	if (iFunction->GetContext()->GetIsolate() != mContext->GetIsolate())
+		throw gcnew System::ArgumentException("The function belongs to a context on another isolate.", "iFunction");
+	if (iFunction->GetContext() != mContext)
+		// Its own global object is the receiver, so it needs its own context.
+		return iFunction->Call(System::Threading::Timeout::InfiniteTimeSpan, iArgs);
+	return iFunction->CallInScope(System::Threading::Timeout::InfiniteTimeSpan, iArgs);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,85 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+#include "JavascriptContext.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ref class JavascriptFunction;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptSession
+//
+// Returned by JavascriptContext::BeginSession().  Holds the isolate lock
+// and the context entry from construction until disposal, so that a batch
+// of calls only pays for them once.  Other threads cannot use the isolate
+// in the meantime, and the session can only be used, and must be disposed,
+// on the thread that began it.  Disposing it on another thread does nothing
+// but write a trace message.  Always begin one in a using block: a session
+// that is never disposed keeps the isolate locked for good, which the
+// finalizer can only report.
+//
+// Sessions on one thread nest, and are left innermost first.  One disposed
+// while sessions begun after it are still open is left along with them.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptSession: public System::IDisposable
+{
+internal:
+	JavascriptSession(JavascriptContext^ iContext);
+
+public:
+	~JavascriptSession();
+
+	!JavascriptSession();
+
+	void SetParameter(System::String^ iName, System::Object^ iObject);
+
+	void SetParameter(System::String^ iName, System::Object^ iObject, SetParameterOptions options);
+
+	System::Object^ GetParameter(System::String^ iName);
+
+	void SetParameterJson(System::String^ iName, cli::array<System::Byte>^ iUtf8Json);
+
+	cli::array<System::Byte>^ GetParameterJson(System::String^ iName);
+
+	System::Object^ Run(System::String^ iScript);
+
+	System::Object^ Run(System::String^ iScript, System::String^ iScriptResourceName);
+
+	System::Object^ Run(System::String^ iScript, System::TimeSpan iTimeout);
+
+	// iFunction must belong to a context on the same isolate.
+	System::Object^ Call(JavascriptFunction^ iFunction, ... cli::array<System::Object^>^ iArgs);
+
+	property JavascriptContext^ Context { JavascriptContext^ get() { return mContext; } }
+
+private:
+	void CheckUsable();
+
+	// Leaves the disposed sessions at the top of this thread's stack.
+	static void LeaveDisposedSessions();
+
+	[System::ThreadStaticAttribute] static JavascriptSession ^sCurrentSession;
+
+	// The session that was current when we began.
+	JavascriptSession^ mOuterSession;
+
+	JavascriptContext^ mContext;
+	JavascriptContext^ mOldContext;
+	v8::Locker *mLocker;
+	int mThreadId;
+	bool mDisposed;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,185 @@
+#include <vcclr.h>
+
+#include "JavascriptSnapshot.h"
+
+#include "JavascriptContext.h"
+#include "JavascriptException.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace v8;
+
+// Prefixes serialized snapshots so that Load() can reject foreign files
+// and blobs from other versions of v8.
+static const char *kSnapshotMagic = "JavascriptNetSnapshot";
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot::JavascriptSnapshot(const char *iData, int iSize)
+{
+	mStartupData = new StartupData();
+	mStartupData->data = iData;
+	mStartupData->raw_size = iSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot::!JavascriptSnapshot()
+{
+	if (mStartupData != NULL)
+	{
+		delete[] mStartupData->data;
+		delete mStartupData;
+		mStartupData = NULL;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot^
+JavascriptSnapshot::Create(System::String^ iBootstrapScript)
+{
+	return Create(iBootstrapScript, "bootstrap");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot^
+JavascriptSnapshot::Create(System::String^ iBootstrapScript, System::String^ iScriptResourceName)
+{
+	if (iBootstrapScript == nullptr)
+		throw gcnew System::ArgumentNullException("iBootstrapScript");
+	if (iScriptResourceName == nullptr)
+		throw gcnew System::ArgumentNullException("iScriptResourceName");
+	JavascriptContext::EnsureV8Initialised();
+
+	pin_ptr<const wchar_t> scriptPtr = PtrToStringChars(iBootstrapScript);
+	pin_ptr<const wchar_t> resourceNamePtr = PtrToStringChars(iScriptResourceName);
+	System::String^ error = nullptr;
+	StartupData blob;
+	{
+		// The creator owns (and has already entered) its own isolate, which
+		// is disposed when the creator goes out of scope.
+		SnapshotCreator creator;
+		v8::Isolate *isolate = creator.GetIsolate();
+		v8::Locker v8ThreadLock(isolate);
+		{
+			HandleScope handleScope(isolate);
+			Local<Context> context = Context::New(isolate);
+			{
+				Context::Scope contextScope(context);
+				TryCatch tryCatch(isolate);
+				Local<String> source = String::NewFromTwoByte(isolate, (uint16_t const *)scriptPtr, v8::NewStringType::kNormal).ToLocalChecked();
+				Local<String> resource = String::NewFromTwoByte(isolate, (uint16_t const *)resourceNamePtr, v8::NewStringType::kNormal).ToLocalChecked();
+				ScriptOrigin origin(resource);
+				MaybeLocal<Script> script = Script::Compile(context, source, &origin);
+				if (script.IsEmpty() || script.ToLocalChecked()->Run(context).IsEmpty())
+				{
+					if (tryCatch.Exception().IsEmpty() || tryCatch.Exception()->IsNull())
+						error = "Execution Terminated";
+					else
+						error = gcnew System::String((wchar_t*) *String::Value(isolate, tryCatch.Exception()));
+				}
+			}
+			// CreateBlob() insists on a default context even when we are
+			// only going to throw the result away.
+			creator.SetDefaultContext(context);
+		}
+		// kKeep saves new contexts from recompiling the library functions
+		// that the bootstrap script already ran.
+		blob = creator.CreateBlob(SnapshotCreator::FunctionCodeHandling::kKeep);
+	}
+
+	if (error != nullptr)
+	{
+		delete[] blob.data;
+		pin_ptr<const wchar_t> errorPtr = PtrToStringChars(error);
+		throw gcnew JavascriptException((wchar_t const *)errorPtr);
+	}
+	if (blob.data == NULL)
+		throw gcnew JavascriptException(L"v8 failed to create a snapshot");
+
+	return gcnew JavascriptSnapshot(blob.data, blob.raw_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot^
+JavascriptSnapshot::Load(System::String^ iPath)
+{
+	if (iPath == nullptr)
+		throw gcnew System::ArgumentNullException("iPath");
+	return FromArray(System::IO::File::ReadAllBytes(iPath));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptSnapshot^
+JavascriptSnapshot::FromArray(cli::array<System::Byte>^ iBytes)
+{
+	if (iBytes == nullptr)
+		throw gcnew System::ArgumentNullException("iBytes");
+
+	System::IO::BinaryReader reader(gcnew System::IO::MemoryStream(iBytes));
+	System::String^ magic;
+	System::String^ version;
+	int size;
+	try
+	{
+		magic = reader.ReadString();
+		version = reader.ReadString();
+		size = reader.ReadInt32();
+	}
+	catch (System::IO::EndOfStreamException^)
+	{
+		throw gcnew System::ArgumentException("Not a JavascriptSnapshot.", "iBytes");
+	}
+	if (!System::String::Equals(magic, gcnew System::String(kSnapshotMagic)))
+		throw gcnew System::ArgumentException("Not a JavascriptSnapshot.", "iBytes");
+	if (!System::String::Equals(version, JavascriptContext::V8Version))
+		throw gcnew System::ArgumentException("Snapshot was made by v8 " + version + " but this is v8 " + JavascriptContext::V8Version + ".", "iBytes");
+	int offset = (int)reader.BaseStream->Position;
+	if (size < 0 || size > iBytes->Length - offset)
+		throw gcnew System::ArgumentException("Snapshot is truncated.", "iBytes");
+
+	char *data = new char[size];
+	System::Runtime::InteropServices::Marshal::Copy(iBytes, offset, System::IntPtr(data), size);
+	return gcnew JavascriptSnapshot(data, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptSnapshot::Save(System::String^ iPath)
+{
+	if (iPath == nullptr)
+		throw gcnew System::ArgumentNullException("iPath");
+	System::IO::File::WriteAllBytes(iPath, ToArray());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+cli::array<System::Byte>^
+JavascriptSnapshot::ToArray()
+{
+	System::IO::MemoryStream^ stream = gcnew System::IO::MemoryStream();
+	System::IO::BinaryWriter writer(stream);
+	writer.Write(gcnew System::String(kSnapshotMagic));
+	writer.Write(JavascriptContext::V8Version);
+	writer.Write(mStartupData->raw_size);
+	cli::array<System::Byte>^ blob = gcnew cli::array<System::Byte>(mStartupData->raw_size);
+	System::Runtime::InteropServices::Marshal::Copy(System::IntPtr((void *)mStartupData->data), blob, 0, mStartupData->raw_size);
+	writer.Write(blob);
+	writer.Flush();
+	return stream->ToArray();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
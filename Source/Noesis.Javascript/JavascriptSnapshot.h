@@ -0,0 +1,77 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptSnapshot
+//
+// A v8 startup snapshot taken after running a bootstrap script.  Contexts
+// constructed from it start with whatever the script left in the global
+// scope, without running it again.
+//
+// Snapshots are specific to the v8 version that made them.  Save() records
+// the version and Load() refuses blobs from any other, because v8 itself
+// would abort the process on a mismatch.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+public ref class JavascriptSnapshot
+{
+	////////////////////////////////////////////////////////////
+	// Constructor
+	////////////////////////////////////////////////////////////
+public:
+
+	static JavascriptSnapshot^ Create(System::String^ iBootstrapScript);
+
+	static JavascriptSnapshot^ Create(System::String^ iBootstrapScript, System::String^ iScriptResourceName);
+
+	static JavascriptSnapshot^ Load(System::String^ iPath);
+
+	static JavascriptSnapshot^ FromArray(cli::array<System::Byte>^ iBytes);
+
+	// The blob is read lazily by isolates, so it must live as long as any
+	// JavascriptContext made from it.  Those contexts hold a reference to
+	// us, so we only free it on finalization.
+	!JavascriptSnapshot();
+
+	////////////////////////////////////////////////////////////
+	// Public methods
+	////////////////////////////////////////////////////////////
+public:
+
+	void Save(System::String^ iPath);
+
+	cli::array<System::Byte>^ ToArray();
+
+	property int Size { int get() { return mStartupData->raw_size; } }
+
+	////////////////////////////////////////////////////////////
+	// Internal methods
+	////////////////////////////////////////////////////////////
+internal:
+
+	v8::StartupData *GetStartupData() { return mStartupData; }
+
+private:
+
+	// Takes ownership of iData, which must have been allocated with new[].
+	JavascriptSnapshot(const char *iData, int iSize);
+
+	////////////////////////////////////////////////////////////
+	// Data members
+	////////////////////////////////////////////////////////////
+private:
+
+	v8::StartupData *mStartupData;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,182 @@
+#include <windows.h>
+#include <msclr\lock.h>
+
+#include "JavascriptWatchdog.h"
+#include "JavascriptException.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace msclr;
+using namespace System::Collections::Generic;
+using namespace System::Threading;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static JavascriptWatchdog::JavascriptWatchdog()
+{
+	sWheel = gcnew cli::array<LinkedList<Entry^>^>(WheelSize);
+	for (int i = 0; i < WheelSize; i++)
+		sWheel[i] = gcnew LinkedList<Entry^>();
+	sClock = System::Diagnostics::Stopwatch::StartNew();
+	sThread = gcnew Thread(gcnew ThreadStart(&JavascriptWatchdog::Watch));
+	sThread->IsBackground = true;
+	sThread->Name = "Javascript watchdog";
+	sThread->Start();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+long long
+JavascriptWatchdog::CurrentTick()
+{
+	return sClock->ElapsedMilliseconds / TickMilliseconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptWatchdog::Entry^
+JavascriptWatchdog::Start(v8::Isolate *iIsolate, System::TimeSpan iTimeout)
+{
+	Entry^ entry = gcnew Entry();
+	entry->isolate = iIsolate;
+
+	// Round up, so that we never fire early.
+	long long ticks = (long long)System::Math::Ceiling(iTimeout.TotalMilliseconds / TickMilliseconds);
+	if (ticks < 1)
+		ticks = 1;
+
+	lock l(sWheel);
+	entry->deadline = CurrentTick() + ticks;
+	entry->node = sWheel[(int)(entry->deadline % WheelSize)]->AddLast(entry);
+	if (sCount++ == 0)
+		Monitor::Pulse(sWheel);
+	return entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool
+JavascriptWatchdog::Stop(Entry^ iEntry)
+{
+	lock l(sWheel);
+	if (iEntry->node != nullptr)
+	{
+		iEntry->node->List->Remove(iEntry->node);
+		iEntry->node = nullptr;
+		sCount--;
+	}
+	return iEntry->expired;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptWatchdog::Watch()
+{
+	lock l(sWheel);
+	long long processed = CurrentTick();
+	while (true)
+	{
+		if (sCount == 0)
+			Monitor::Wait(sWheel);
+		else
+			Monitor::Wait(sWheel, TickMilliseconds);
+
+		// Visit each slot the clock has passed since last time.  After a
+		// long sleep, once round the wheel covers everything.
+		long long now = CurrentTick();
+		long long first = System::Math::Max(processed + 1, now - WheelSize + 1);
+		for (long long tick = first; tick <= now; tick++)
+		{
+			LinkedList<Entry^>^ slot = sWheel[(int)(tick % WheelSize)];
+			LinkedListNode<Entry^>^ node = slot->First;
+			while (node != nullptr)
+			{
+				LinkedListNode<Entry^>^ next = node->Next;
+				Entry^ entry = node->Value;
+
+				// Entries more than one revolution away stay put.
+				if (entry->deadline <= now)
+				{
+					slot->Remove(node);
+					entry->node = nullptr;
+					entry->expired = true;
+					sCount--;
+
+					// Safe from any thread.  Stop() can't run until we let go of
+					// the lock, so the isolate is still busy with the late call.
+					entry->isolate->TerminateExecution();
+				}
+				node = next;
+			}
+		}
+		processed = now;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static long long GetCurrentThreadCpuTime()
+{
+	FILETIME creation, exit, kernel, user;
+	if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+		return 0;
+	return (((long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime)
+		+ (((long long)user.dwHighDateTime << 32) | user.dwLowDateTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+JavascriptTimeout::JavascriptTimeout(v8::Isolate *iIsolate, System::TimeSpan iTimeout)
+{
+	if (iTimeout == Timeout::InfiniteTimeSpan)
+		return;
+	if (iTimeout <= System::TimeSpan::Zero)
+		throw gcnew System::ArgumentOutOfRangeException("timeout");
+
+	mIsolate = iIsolate;
+	mTimeout = iTimeout;
+	mStartTimestamp = System::Diagnostics::Stopwatch::GetTimestamp();
+	mStartCpuTime = GetCurrentThreadCpuTime();
+	mEntry = JavascriptWatchdog::Start(iIsolate, iTimeout);
+}
+
+JavascriptTimeout::~JavascriptTimeout()
+{
+	if (mEntry != nullptr && JavascriptWatchdog::Stop(mEntry))
+		mIsolate->CancelTerminateExecution();
+	mEntry = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+JavascriptTimeout::Stop(bool iSucceeded)
+{
+	if (mEntry == nullptr)
+		return;
+	bool expired = JavascriptWatchdog::Stop(mEntry);
+	mEntry = nullptr;
+	if (!expired)
+		return;
+
+	// Otherwise the next call into the isolate would be terminated too.
+	mIsolate->CancelTerminateExecution();
+	if (iSucceeded)
+		return;
+
+	long long elapsedTicks = System::Diagnostics::Stopwatch::GetTimestamp() - mStartTimestamp;
+	System::TimeSpan elapsed = System::TimeSpan::FromSeconds((double)elapsedTicks / System::Diagnostics::Stopwatch::Frequency);
+	System::TimeSpan cpuTime = System::TimeSpan::FromTicks(GetCurrentThreadCpuTime() - mStartCpuTime);
+	throw gcnew JavascriptTimeoutException(mTimeout, elapsed, cpuTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
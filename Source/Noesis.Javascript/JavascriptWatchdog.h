@@ -0,0 +1,92 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <v8.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Noesis { namespace Javascript {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptWatchdog
+//
+// One background thread that terminates scripts which run past their
+// timeouts, so that callers do not each need a timer of their own.
+// Deadlines live in a timer wheel with TickMilliseconds resolution, which
+// makes adding and removing them O(1).  The thread sleeps when there is
+// nothing to watch.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class JavascriptWatchdog abstract sealed
+{
+public:
+
+	ref class Entry
+	{
+	internal:
+		v8::Isolate *isolate;
+		long long deadline;  // in ticks
+		System::Collections::Generic::LinkedListNode<Entry^>^ node;  // null once off the wheel
+		bool expired;
+	};
+
+	literal int TickMilliseconds = 10;
+
+	// The isolate will be terminated if Stop() has not been called within
+	// iTimeout.
+	static Entry^ Start(v8::Isolate *iIsolate, System::TimeSpan iTimeout);
+
+	// Returns true if the isolate was terminated.
+	static bool Stop(Entry^ iEntry);
+
+private:
+
+	static JavascriptWatchdog();
+
+	static long long CurrentTick();
+
+	static void Watch();
+
+	literal int WheelSize = 256;
+
+	// Also the lock for everything else here.
+	static cli::array<System::Collections::Generic::LinkedList<Entry^>^>^ sWheel;
+
+	static int sCount;
+
+	static System::Diagnostics::Stopwatch^ sClock;
+
+	static System::Threading::Thread^ sThread;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// JavascriptTimeout
+//
+// Stack-allocate one of these around a call into v8 to put it under the
+// watchdog.  An infinite timeout does nothing.
+////////////////////////////////////////////////////////////////////////////////////////////////////
+ref class JavascriptTimeout
+{
+public:
+	JavascriptTimeout(v8::Isolate *iIsolate, System::TimeSpan iTimeout);
+
+	~JavascriptTimeout();
+
+	// Call as soon as v8 returns.  If the watchdog terminated the call then
+	// this clears the termination and, unless the call managed to return a
+	// value anyway, throws JavascriptTimeoutException.
+	void Stop(bool iSucceeded);
+
+private:
+	v8::Isolate *mIsolate;
+	System::TimeSpan mTimeout;
+	JavascriptWatchdog::Entry^ mEntry;
+	long long mStartTimestamp;
+	long long mStartCpuTime;  // in 100ns units
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+} } // namespace Noesis::Javascript
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -61,6 +61,17 @@ SystemInterop::ConvertToType(System::Object^ iValue, System::Type^ iType)
 			return ConvertToInt16(iValue);
 		else if (iType == System::Int32::typeid)
 			return ConvertToInt32(iValue);
+		else if (IsIntegerType(iType))
+		{
+			try
+			{
+				return ConvertToInteger(iValue, iType);
+			}
+			catch (System::InvalidCastException^)
+			{
+				return nullptr;
+			}
+		}
 		else if (iType == System::Single::typeid)
 			return ConvertToSingle(iValue);
 		else if (iType == System::Double::typeid)
@@ -202,6 +213,53 @@ SystemInterop::ConvertToInt32(System::Object^ iValue)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+System::Object^
+SystemInterop::ConvertToInteger(System::Object^ iValue, System::Type^ iType)
+{
+	System::Object^ value = iValue;
+	System::Type^ type = iValue->GetType();
+	if (type == System::Double::typeid)
+		value = System::Math::Truncate((double) iValue);
+	else if (type == System::Single::typeid)
+		value = System::Math::Truncate((double) ((float) iValue));
+	else if (type == System::Decimal::typeid)
+		value = System::Decimal::Truncate((System::Decimal) iValue);
+
+	try
+	{
+		// Convert::ToChar() only takes strings and integers.
+		if (iType == System::Char::typeid && type != System::String::typeid)
+			return (System::Char) System::Convert::ToUInt16(value, System::Globalization::CultureInfo::InvariantCulture);
+		return System::Convert::ChangeType(value, iType, System::Globalization::CultureInfo::InvariantCulture);
+	}
+	catch (System::FormatException^ e)
+	{
+		throw gcnew System::InvalidCastException("Cannot convert " + type->FullName + " to " + iType->FullName + ".", e);
+	}
+	catch (System::OverflowException^ e)
+	{
+		throw gcnew System::InvalidCastException("Cannot convert " + type->FullName + " to " + iType->FullName + ".", e);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool
+SystemInterop::IsIntegerType(System::Type^ iType)
+{
+	return iType == System::Int16::typeid
+		|| iType == System::Int32::typeid
+		|| iType == System::Int64::typeid
+		|| iType == System::UInt16::typeid
+		|| iType == System::UInt32::typeid
+		|| iType == System::UInt64::typeid
+		|| iType == System::Byte::typeid
+		|| iType == System::SByte::typeid
+		|| iType == System::Char::typeid;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 float
 SystemInterop::ConvertToSingle(System::Object^ iValue)
 {
@@ -56,6 +56,13 @@ public:
 
 	static int ConvertToInt32(System::Object^ iValue);
 
+	// Any of the integer types, or Char.  Fractions are truncated, but
+	// values that don't fit or don't parse throw InvalidCastException
+	// rather than wrapping around or becoming zero.
+	static System::Object^ ConvertToInteger(System::Object^ iValue, System::Type^ iType);
+
+	static bool IsIntegerType(System::Type^ iType);
+
 	static float ConvertToSingle(System::Object^ iValue);
 
 	static double ConvertToDouble(System::Object^ iValue);
@@ -258,5 +258,71 @@ test.prop.complex = complex;");
             _context.Run("my_object.EnumeratedValue = 1.0");
             my_object.EnumeratedValue.Should().Be(UriKind.Absolute);
         }
+
+        class ClassWithAssortedProperties
+        {
+            public int Number { get; set; }
+            public static string Shared { get; set; }
+            public string Failing { get { throw new InvalidOperationException("Getter failed"); } }
+        }
+
+        [TestMethod]
+        public void RepeatedPropertyAccessSeesCurrentValues()
+        {
+            var my_object = new ClassWithAssortedProperties();
+            _context.SetParameter("my_object", my_object);
+
+            _context.Run("for (var i = 0; i < 100; i++) my_object.Number = my_object.Number + 1; my_object.Number").Should().Be(100);
+            my_object.Number.Should().Be(100);
+        }
+
+        [TestMethod]
+        public void SettingNullOnAValueTypePropertyStoresItsDefault()
+        {
+            var my_object = new ClassWithAssortedProperties { Number = 5 };
+            _context.SetParameter("my_object", my_object);
+
+            _context.Run("my_object.Number = null");
+
+            my_object.Number.Should().Be(0);
+        }
+
+        [TestMethod]
+        public void StaticPropertiesCanBeAccessedThroughInstances()
+        {
+            _context.SetParameter("my_object", new ClassWithAssortedProperties());
+
+            _context.Run("my_object.Shared = 'shared'; my_object.Shared").Should().Be("shared");
+        }
+
+        [TestMethod]
+        public void ExceptionsFromGettersReachJavascript()
+        {
+            _context.SetParameter("my_object", new ClassWithAssortedProperties());
+
+            _context.Run("try { my_object.Failing } catch (e) { e.message }").Should().Be("Getter failed");
+        }
+
+        [TestMethod]
+        public void MissingPropertiesStayUndefined()
+        {
+            _context.SetParameter("a", new ClassWithAssortedProperties());
+            _context.SetParameter("b", new ClassWithAssortedProperties());
+
+            _context.Run("a.missing === undefined && b.missing === undefined && a.missing === undefined").Should().Be(true);
+        }
+
+        struct StructWithProperty
+        {
+            public int Value { get; set; }
+        }
+
+        [TestMethod]
+        public void SettingAPropertyOnAStructSticks()
+        {
+            _context.SetParameter("my_struct", new StructWithProperty());
+
+            _context.Run("my_struct.Value = 3; my_struct.Value").Should().Be(3);
+        }
     }
 }
\ No newline at end of file
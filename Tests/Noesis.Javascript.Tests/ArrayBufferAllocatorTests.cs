@@ -0,0 +1,68 @@
+﻿using System;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class ArrayBufferAllocatorTests
+    {
+        [TestMethod]
+        public void ArrayBufferMemoryIsCounted()
+        {
+            using (var context = new JavascriptContext())
+            {
+                context.Run("var keep = new Uint8Array(1024 * 1024);");
+
+                var statistics = context.GetHeapStatistics();
+                statistics.ArrayBufferMemory.Should().BeGreaterOrEqualTo(1024 * 1024);
+                statistics.ArrayBufferAllocations.Should().BeGreaterOrEqualTo(1);
+            }
+        }
+
+        [TestMethod]
+        public void BuffersAreZeroed()
+        {
+            using (var context = new JavascriptContext())
+            {
+                // Churn so that the second buffer reuses a pooled block.
+                context.Run("(function () { var a = new Uint8Array(100); a.fill(255); })()");
+                context.Collect();
+
+                context.Run("new Uint8Array(100).every(function (b) { return b === 0; })").Should().Be(true);
+            }
+        }
+
+        [TestMethod]
+        public void CapTurnsIntoRangeError()
+        {
+            using (var context = new JavascriptContext(new JavascriptHeapLimits { MaxArrayBufferMemoryMB = 1 }))
+            {
+                context.Run("var small = new ArrayBuffer(512 * 1024);");
+
+                Action action = () => context.Run("var big = new ArrayBuffer(1024 * 1024);");
+
+                action.ShouldThrow<JavascriptException>().Which.Message.Should().Contain("RangeError");
+                context.GetHeapStatistics().FailedArrayBufferAllocations.Should().Be(1);
+                context.Run("small.byteLength").Should().Be(512 * 1024);
+            }
+        }
+
+        [TestMethod]
+        public void SmallBuffersAreRecycled()
+        {
+            using (var context = new JavascriptContext())
+            {
+                long hits = JavascriptIsolate.ArrayBufferPoolHits;
+
+                for (int i = 0; i < 20; i++)
+                {
+                    context.Run("(function () { for (var i = 0; i < 100; i++) new Float64Array(64); })()");
+                    context.Collect();
+                }
+
+                JavascriptIsolate.ArrayBufferPoolHits.Should().BeGreaterThan(hits);
+            }
+        }
+    }
+}
@@ -0,0 +1,66 @@
+﻿using System;
+using System.IO;
+using System.Linq;
+using System.Threading;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class CodeCacheTests
+    {
+        private string _directory;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _directory = Path.Combine(Path.GetTempPath(), Guid.NewGuid().ToString("N"));
+            JavascriptCodeCache.Enable(_directory);
+            JavascriptCodeCache.MinimumSourceLength = 0;
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            JavascriptCodeCache.Disable();
+            JavascriptCodeCache.MinimumSourceLength = 1024;
+            Directory.Delete(_directory, true);
+        }
+
+        [TestMethod]
+        public void SecondCompilationConsumesTheCacheFile()
+        {
+            const string script = "function square(x) { return x * x; } square(7)";
+            using (var context = new JavascriptContext())
+                context.Run(script).Should().Be(49);
+
+            // The file is written on the thread pool.
+            for (int i = 0; i < 100 && !Directory.EnumerateFiles(_directory, "*.bin").Any(); i++)
+                Thread.Sleep(50);
+            Directory.EnumerateFiles(_directory, "*.bin").Should().HaveCount(1);
+
+            long hits = JavascriptCodeCache.Hits;
+            using (var context = new JavascriptContext())
+                context.Run(script).Should().Be(49);
+            JavascriptCodeCache.Hits.Should().Be(hits + 1);
+        }
+
+        [TestMethod]
+        public void CorruptCacheFileIsRejectedAndReplaced()
+        {
+            const string script = "'corrupt' + 1";
+            using (var context = new JavascriptContext())
+                context.Run(script);
+            for (int i = 0; i < 100 && !Directory.EnumerateFiles(_directory, "*.bin").Any(); i++)
+                Thread.Sleep(50);
+            string file = Directory.EnumerateFiles(_directory, "*.bin").Single();
+            File.WriteAllBytes(file, new byte[] { 1, 2, 3, 4, 5, 6, 7, 8 });
+
+            long rejections = JavascriptCodeCache.Rejections;
+            using (var context = new JavascriptContext())
+                context.Run(script).Should().Be("corrupt1");
+            JavascriptCodeCache.Rejections.Should().Be(rejections + 1);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+﻿using System;
+using System.Runtime.CompilerServices;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class CompiledScriptTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void CompiledScriptCanBeRunRepeatedly()
+        {
+            _context.Run("var counter = 0;");
+            using (var script = _context.Compile("++counter"))
+            {
+                script.Run().Should().Be(1);
+                script.Run().Should().Be(2);
+                script.Run().Should().Be(3);
+            }
+        }
+
+        [TestMethod]
+        public void CompiledScriptSeesCurrentParameters()
+        {
+            var script = _context.Compile("x * 2");
+            _context.SetParameter("x", 3);
+            script.Run().Should().Be(6);
+            _context.SetParameter("x", 5);
+            script.Run().Should().Be(10);
+        }
+
+        [TestMethod]
+        public void CompileReportsSyntaxErrors()
+        {
+            Action action = () => _context.Compile("function (", "broken.js");
+
+            action.ShouldThrowExactly<JavascriptException>();
+        }
+
+        [TestMethod]
+        public void RunningAScriptAfterDisposingItThrows()
+        {
+            var script = _context.Compile("1");
+            script.Dispose();
+
+            Action action = () => script.Run();
+
+            action.ShouldThrowExactly<ObjectDisposedException>();
+        }
+
+        [TestMethod]
+        public void DisposedScriptsAreLetGoOfByTheIsolate()
+        {
+            WeakReference script = CompileAndDispose(_context);
+
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            GC.Collect();
+
+            script.IsAlive.Should().BeFalse();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static WeakReference CompileAndDispose(JavascriptContext context)
+        {
+            var script = context.Compile("1");
+            script.Run().Should().Be(1);
+            script.Dispose();
+            return new WeakReference(script);
+        }
+
+        [TestMethod]
+        public void ScriptsOutliveTheContextThatCompiledThem()
+        {
+            using (var isolate = new JavascriptIsolate())
+            {
+                JavascriptScript script;
+                using (var first = isolate.CreateContext())
+                    script = first.Compile("1 + 1");
+
+                using (var second = isolate.CreateContext())
+                    script.Run(second).Should().Be(2);
+            }
+        }
+
+        [TestMethod]
+        public void ScriptsCanBeRunAfterTheirLeaseIsReturned()
+        {
+            using (var pool = new JavascriptContextPool(0, 1, TimeSpan.FromMinutes(1))) {
+                var context = pool.Acquire();
+                var script = context.Compile("typeof leftOver");
+                context.SetParameter("leftOver", 1);
+                pool.Release(context);
+
+                var again = pool.Acquire();
+                script.Run(again).Should().Be("undefined");
+                script.Run().Should().Be("undefined");
+                pool.Release(again);
+            }
+        }
+
+        [TestMethod]
+        public void RepeatedRunsGiveFreshResultsWithTheCacheOnAndOff()
+        {
+            _context.Run("var n = 0;");
+            _context.Run("++n").Should().Be(1);
+            _context.Run("++n").Should().Be(2);
+
+            _context.CompiledScriptCacheSize = 0;
+            _context.Run("++n").Should().Be(3);
+            _context.Run("++n", "counter.js").Should().Be(4);
+        }
+
+        [TestMethod]
+        public void CachedScriptIsRecompiledUnderANewResourceName()
+        {
+            const string script = "throw new Error('boom')";
+            Action first = () => _context.Run(script, "first.js");
+            Action second = () => _context.Run(script, "second.js");
+
+            first.ShouldThrow<JavascriptException>().Which.Source.Should().Be("first.js");
+            second.ShouldThrow<JavascriptException>().Which.Source.Should().Be("second.js");
+        }
+    }
+}
@@ -0,0 +1,69 @@
+﻿using System;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class ContextPoolTests
+    {
+        [TestMethod]
+        public void ReleasedContextIsReusedWithAFreshGlobalScope()
+        {
+            using (var pool = new JavascriptContextPool(1, 2, TimeSpan.FromMinutes(1))) {
+                var context = pool.Acquire();
+                context.SetParameter("leftOver", new object());
+                context.Run("var fromScript = 42;");
+                pool.Release(context);
+
+                var again = pool.Acquire();
+                again.Should().BeSameAs(context);
+                again.Run("typeof leftOver === 'undefined' && typeof fromScript === 'undefined'").Should().Be(true);
+                pool.Release(again);
+            }
+        }
+
+        [TestMethod]
+        public void CountsHitsAndMisses()
+        {
+            using (var pool = new JavascriptContextPool(1, 1, TimeSpan.FromMinutes(1))) {
+                var first = pool.Acquire();
+                var second = pool.Acquire();
+                pool.Hits.Should().Be(1);
+                pool.Misses.Should().Be(1);
+
+                pool.Release(first);
+                pool.Release(second);  // over MaxSize, so disposed
+                pool.IdleCount.Should().Be(1);
+            }
+        }
+
+        [TestMethod]
+        public void TerminatedContextIsUsableAfterRelease()
+        {
+            using (var pool = new JavascriptContextPool(0, 1, TimeSpan.FromMinutes(1))) {
+                var context = pool.Acquire();
+                context.TerminateExecution(true);
+                pool.Release(context);
+
+                var again = pool.Acquire();
+                again.Run("1 + 1").Should().Be(2);
+                pool.Release(again);
+            }
+        }
+
+        [TestMethod]
+        public void ContextTerminatedWhileIdleIsUsableAfterRelease()
+        {
+            using (var pool = new JavascriptContextPool(0, 1, TimeSpan.FromMinutes(1))) {
+                var context = pool.Acquire();
+                context.TerminateExecution();
+                pool.Release(context);
+
+                var again = pool.Acquire();
+                again.Run("1 + 1").Should().Be(2);
+                pool.Release(again);
+            }
+        }
+    }
+}
@@ -154,6 +154,14 @@ namespace Noesis.Javascript.Tests
             _context.GetParameter("UniString").Should().BeOfType<string>().Which.Should().Be("呵呵呵呵呵");
         }
 
+        [TestMethod]
+        public void ReadLatin1StringsOfManyLengths()
+        {
+            foreach (int length in new[] { 0, 1, 15, 16, 17, 255, 256, 257, 1000 }) {
+                _context.Run("new Array(" + (length + 1) + ").join('\\u00e9')").Should().Be(new string('\u00e9', length));
+            }
+        }
+
         [TestMethod]
         public void SelfReferentialObjectDoesNotCauseStackOverflow()
         {
@@ -165,5 +173,111 @@ namespace Noesis.Javascript.Tests
         {
             _context.Run("a = []; a.push(a)");
         }
+
+        [TestMethod]
+        public void RunAsDoubleArray()
+        {
+            _context.Run<double[]>("[1, 2.5, -3]").Should().Equal(1.0, 2.5, -3.0);
+        }
+
+        [TestMethod]
+        public void GetParameterAsIntArray()
+        {
+            _context.Run("var values = []; for (var i = 0; i < 1000; i++) values.push(i);");
+
+            int[] values = _context.GetParameter<int[]>("values");
+
+            values.Should().HaveCount(1000);
+            values[999].Should().Be(999);
+        }
+
+        [TestMethod]
+        public void RunAsIntArrayConvertsNonIntegers()
+        {
+            _context.Run<int[]>("[1, '2']").Should().Equal(1, 2);
+        }
+
+        [TestMethod]
+        public void RunAsTypedValue()
+        {
+            _context.Run<string>("'abc'").Should().Be("abc");
+            _context.Run<double>("1.5").Should().Be(1.5);
+            _context.Run<string[]>("['a', 'b']").Should().Equal("a", "b");
+        }
+
+        [TestMethod]
+        public void RunAsUnconvertibleTypeThrows()
+        {
+            Action action = () => _context.Run<Regex>("1");
+            action.ShouldThrow<InvalidCastException>();
+        }
+
+        [TestMethod]
+        public void NullAsValueTypeThrowsInvalidCast()
+        {
+            Action run = () => _context.Run<int>("undefined");
+            run.ShouldThrow<InvalidCastException>();
+
+            Action get = () => _context.GetParameter<double>("missing");
+            get.ShouldThrow<InvalidCastException>();
+
+            _context.Run<int?>("null").Should().NotHaveValue();
+            _context.Run<string>("null").Should().BeNull();
+        }
+
+        [TestMethod]
+        public void RunAsOtherIntegerTypes()
+        {
+            _context.Run<long>("Math.pow(2, 40)").Should().Be(1099511627776L);
+            _context.Run<long>("-2.5").Should().Be(-2L);
+            _context.Run<byte>("255").Should().Be((byte)255);
+            _context.Run<byte>("'7'").Should().Be((byte)7);
+            _context.Run<ulong?>("3").Should().Be(3UL);
+            _context.Run<char>("'x'").Should().Be('x');
+        }
+
+        [TestMethod]
+        public void RunAsIntegerThatDoesNotFitOrParseThrowsInvalidCast()
+        {
+            Action tooBig = () => _context.Run<byte>("256");
+            tooBig.ShouldThrow<InvalidCastException>().WithInnerException<OverflowException>();
+
+            Action negative = () => _context.Run<uint>("-1");
+            negative.ShouldThrow<InvalidCastException>();
+
+            Action notANumber = () => _context.Run<int>("'abc'");
+            notANumber.ShouldThrow<InvalidCastException>().WithInnerException<FormatException>();
+        }
+
+        [TestMethod]
+        public void ReadFloat64Array()
+        {
+            _context.Run("new Float64Array([1.5, 2.5, 3.5])").Should().BeOfType<double[]>().Which.Should().Equal(1.5, 2.5, 3.5);
+        }
+
+        [TestMethod]
+        public void ReadInt32ArrayView()
+        {
+            _context.Run("new Int32Array([1, 2, 3, 4]).subarray(1, 3)").Should().BeOfType<int[]>().Which.Should().Equal(2, 3);
+        }
+
+        [TestMethod]
+        public void ReadBigIntArrays()
+        {
+            _context.Run("new BigInt64Array([-1n, 2n ** 40n])").Should().BeOfType<long[]>().Which.Should().Equal(-1L, 1099511627776L);
+            _context.Run("new BigUint64Array([2n ** 64n - 1n])").Should().BeOfType<ulong[]>().Which.Should().Equal(ulong.MaxValue);
+        }
+
+        [TestMethod]
+        public void ReadUint8ClampedArray()
+        {
+            _context.Run("new Uint8ClampedArray([-5, 300])").Should().BeOfType<byte[]>().Which.Should().Equal((byte)0, (byte)255);
+        }
+
+        [TestMethod]
+        public void ReadArrayBuffer()
+        {
+            _context.Run("new Uint8Array([7, 8, 9]).buffer").Should().BeOfType<byte[]>().Which.Should().Equal((byte)7, (byte)8, (byte)9);
+        }
     }
 }
@@ -118,6 +118,26 @@ namespace Noesis.Javascript.Tests
 
             _context.Run("val === 'A string from .NET'").Should().BeOfType<bool>().Which.Should().BeTrue();
         }
+
+        [TestMethod]
+        public void SetLatin1AndWideStrings()
+        {
+            string latin1 = new string('\u00ff', 300) + "café";
+            string wide = new string('a', 40) + "\u20ac" + new string('b', 300);
+            _context.SetParameter("latin1", latin1);
+            _context.SetParameter("wide", wide);
+
+            _context.Run("latin1.length === 304 && latin1.charCodeAt(0) === 255 && latin1.slice(-4) === 'caf\\u00e9'").Should().Be(true);
+            _context.Run("wide.length === 341 && wide.charCodeAt(40) === 0x20ac").Should().Be(true);
+        }
+
+        [TestMethod]
+        public void SetStringWithEmbeddedNul()
+        {
+            _context.SetParameter("val", "a\0b");
+
+            _context.Run("val.length").Should().Be(3);
+        }
         
         [TestMethod]
         public void SetArray()
@@ -267,5 +287,124 @@ namespace Noesis.Javascript.Tests
 
             _context.Run("val == 125.25").Should().BeOfType<bool>().Which.Should().BeTrue();
         }
+
+        [TestMethod]
+        public void SetLargeString()
+        {
+            string large = new string('x', 100000) + "end";
+            _context.SetParameter("val", large);
+
+            _context.Run("val.length == 100003 && val.slice(-3) == 'end'").Should().BeOfType<bool>().Which.Should().BeTrue();
+            _context.GetParameter("val").Should().Be(large);
+        }
+
+        [TestMethod]
+        public void SetLargeStringInSeveralContexts()
+        {
+            string large = new string('y', 100000);
+            using (var other = new JavascriptContext()) {
+                _context.SetParameter("val", large);
+                other.SetParameter("val", large);
+                other.Run("val = null");
+                other.Collect();
+
+                _context.Run("val.charAt(99999)").Should().Be("y");
+            }
+            _context.Run("val.length").Should().Be(100000);
+        }
+
+        [TestMethod]
+        public void RunLargeScript()
+        {
+            string script = "var total = 0;" + new string(' ', 100000) + "total += 42; total";
+
+            _context.Run(script).Should().Be(42);
+            _context.Run(script).Should().Be(84);
+        }
+
+        [TestMethod]
+        public void SetByteArray()
+        {
+            _context.SetParameter("val", new byte[] { 1, 2, 255 });
+
+            _context.Run("val instanceof Uint8Array && val.length == 3 && val[2] == 255").Should().BeOfType<bool>().Which.Should().BeTrue();
+        }
+
+        [TestMethod]
+        public void SetDoubleArray()
+        {
+            _context.SetParameter("val", new double[] { 1.5, -2.25 });
+
+            _context.Run("val instanceof Float64Array && val[0] + val[1] == -0.75").Should().BeOfType<bool>().Which.Should().BeTrue();
+        }
+
+        [TestMethod]
+        public void SetFloatArray()
+        {
+            _context.SetParameter("val", new float[] { 0.5f });
+
+            _context.Run("val instanceof Float32Array && val[0] == 0.5").Should().BeOfType<bool>().Which.Should().BeTrue();
+        }
+
+        [TestMethod]
+        public void ScriptWritesToNumericArraysAreSeenByDotNet()
+        {
+            var values = new double[3];
+            _context.SetParameter("val", values);
+
+            _context.Run("val.fill(4)");
+
+            values.Should().Equal(4.0, 4.0, 4.0);
+        }
+
+        class Point
+        {
+            public int X { get; set; }
+            public override bool Equals(object obj) { return obj is Point && ((Point)obj).X == X; }
+            public override int GetHashCode() { return X; }
+        }
+
+        [TestMethod]
+        public void SetSameObjectTwiceGivesSameWrapper()
+        {
+            var point = new Point();
+            _context.SetParameter("a", point);
+            _context.SetParameter("b", point);
+
+            _context.Run("a === b").Should().BeOfType<bool>().Which.Should().BeTrue();
+        }
+
+        [TestMethod]
+        public void WrappersCanBeMapKeys()
+        {
+            var point = new Point();
+            _context.SetParameter("a", point);
+            _context.Run("var map = new Map(); map.set(a, 'found');");
+            _context.SetParameter("b", point);
+
+            _context.Run("map.get(b)").Should().Be("found");
+        }
+
+        [TestMethod]
+        public void SetEqualObjectsGivesDistinctWrappers()
+        {
+            var first = new Point { X = 1 };
+            var second = new Point { X = 1 };
+            _context.SetParameter("a", first);
+            _context.SetParameter("b", second);
+
+            _context.Run("a === b").Should().BeOfType<bool>().Which.Should().BeFalse();
+            _context.GetParameter("b").Should().BeSameAs(second);
+        }
+
+        [TestMethod]
+        public void SetSameDelegateTwiceGivesSameFunction()
+        {
+            Func<int> f = () => 1;
+            _context.SetParameter("a", f);
+            _context.SetParameter("b", f);
+
+            _context.Run("a === b").Should().BeOfType<bool>().Which.Should().BeTrue();
+        }
     }
 }
@@ -0,0 +1,82 @@
+﻿using System;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class HeapLimitTests
+    {
+        private const string Hog = "var hog = []; while (true) hog.push({ index: hog.length, text: 'x' + hog.length });";
+
+        [TestMethod]
+        public void ScriptThatExhaustsTheHeapThrows()
+        {
+            using (var context = new JavascriptContext(new JavascriptHeapLimits { MaxOldSpaceSizeMB = 16 }))
+            {
+                Action action = () => context.Run(Hog);
+
+                action.ShouldThrowExactly<JavascriptOutOfMemoryException>();
+                context.Isolate.IsOutOfMemory.Should().BeTrue();
+            }
+        }
+
+        [TestMethod]
+        public void ContextCannotBeUsedAfterRunningOutOfMemory()
+        {
+            using (var context = new JavascriptContext(new JavascriptHeapLimits { MaxOldSpaceSizeMB = 16 }))
+            {
+                try
+                {
+                    context.Run(Hog);
+                }
+                catch (JavascriptOutOfMemoryException)
+                {
+                }
+
+                Action action = () => context.Run("1");
+
+                action.ShouldThrowExactly<JavascriptOutOfMemoryException>();
+            }
+        }
+
+        [TestMethod]
+        public void OtherContextsAreUnaffected()
+        {
+            using (var healthy = new JavascriptContext())
+            using (var doomed = new JavascriptContext(new JavascriptHeapLimits { MaxOldSpaceSizeMB = 16 }))
+            {
+                healthy.SetParameter("x", 1);
+                try
+                {
+                    doomed.Run(Hog);
+                }
+                catch (JavascriptOutOfMemoryException)
+                {
+                }
+
+                healthy.Run("x + 1").Should().Be(2);
+            }
+        }
+
+        [TestMethod]
+        public void PoolDiscardsContextsThatRanOutOfMemory()
+        {
+            using (var pool = new JavascriptContextPool(0, 2, TimeSpan.FromMinutes(1), null, new JavascriptHeapLimits { MaxOldSpaceSizeMB = 16 }))
+            {
+                var context = pool.Acquire();
+                try
+                {
+                    context.Run(Hog);
+                }
+                catch (JavascriptOutOfMemoryException)
+                {
+                }
+
+                pool.Release(context);
+
+                pool.IdleCount.Should().Be(0);
+            }
+        }
+    }
+}
@@ -0,0 +1,81 @@
+﻿using System.Linq;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class HeapStatisticsTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void HeapStatisticsReflectAllocations()
+        {
+            long before = _context.GetHeapStatistics().UsedHeapSize;
+            _context.Run("var big = []; for (var i = 0; i < 100000; i++) big.push({ i: i });");
+
+            var statistics = _context.GetHeapStatistics();
+
+            statistics.UsedHeapSize.Should().BeGreaterThan(before);
+            statistics.TotalHeapSize.Should().BeGreaterOrEqualTo(statistics.UsedHeapSize);
+            statistics.HeapSizeLimit.Should().BeGreaterThan(0);
+            statistics.NumberOfNativeContexts.Should().BeGreaterOrEqualTo(1);
+            statistics.NumberOfIsolates.Should().Be(1);
+        }
+
+        [TestMethod]
+        public void ExternalMemoryCountsArrayBuffers()
+        {
+            long before = _context.GetHeapStatistics().ExternalMemory;
+            _context.Run("var buffer = new ArrayBuffer(4 * 1024 * 1024);");
+
+            _context.GetHeapStatistics().ExternalMemory.Should().BeGreaterOrEqualTo(before + 4 * 1024 * 1024);
+        }
+
+        [TestMethod]
+        public void HeapSpaceStatisticsNameEachSpace()
+        {
+            var spaces = _context.GetHeapSpaceStatistics();
+
+            spaces.Should().NotBeEmpty();
+            spaces.Select(s => s.SpaceName).Should().Contain("old_space");
+            spaces.Sum(s => s.SpaceUsedSize).Should().BeGreaterThan(0);
+        }
+
+        [TestMethod]
+        public void LastHeapStatisticsIsAvailableWithoutWaiting()
+        {
+            _context.Run("1");
+
+            _context.Isolate.LastHeapStatistics.Should().NotBeNull();
+            _context.Isolate.LastHeapStatistics.UsedHeapSize.Should().BeGreaterThan(0);
+        }
+
+        [TestMethod]
+        public void TotalCoversEveryLiveIsolate()
+        {
+            int before = JavascriptIsolate.GetTotalHeapStatistics().NumberOfIsolates;
+            using (var other = new JavascriptContext())
+            {
+                var total = JavascriptIsolate.GetTotalHeapStatistics();
+
+                total.NumberOfIsolates.Should().Be(before + 1);
+                total.UsedHeapSize.Should().BeGreaterOrEqualTo(other.Isolate.LastHeapStatistics.UsedHeapSize);
+            }
+            JavascriptIsolate.GetTotalHeapStatistics().NumberOfIsolates.Should().Be(before);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+﻿using System;
+using System.Threading;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class IsolateTests
+    {
+        private JavascriptIsolate _isolate;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _isolate = new JavascriptIsolate();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _isolate.Dispose();
+        }
+
+        [TestMethod]
+        public void ContextsOnOneIsolateHaveSeparateGlobals()
+        {
+            using (var first = _isolate.CreateContext())
+            using (var second = _isolate.CreateContext())
+            {
+                first.SetParameter("x", 1);
+                second.SetParameter("x", 2);
+
+                first.Run("x").Should().Be(1);
+                second.Run("x").Should().Be(2);
+                second.Run("typeof y").Should().Be("undefined");
+            }
+        }
+
+        [TestMethod]
+        public void ContextsCanCallIntoEachOtherThroughDotNet()
+        {
+            using (var outer = _isolate.CreateContext())
+            using (var inner = _isolate.CreateContext())
+            {
+                inner.Run("var secret = 42;");
+                outer.SetParameter("inner", new Func<object>(() => inner.Run("secret")));
+
+                outer.Run("inner()").Should().Be(42);
+            }
+        }
+
+        [TestMethod]
+        public void ScriptsCompiledInOneContextRunInAnother()
+        {
+            using (var first = _isolate.CreateContext())
+            using (var second = _isolate.CreateContext())
+            {
+                first.SetParameter("x", 3);
+                second.SetParameter("x", 4);
+                var script = first.Compile("x * x");
+
+                script.Run(first).Should().Be(9);
+                script.Run(second).Should().Be(16);
+            }
+        }
+
+        [TestMethod]
+        public void ScriptsCannotRunOnAnotherIsolate()
+        {
+            using (var first = _isolate.CreateContext())
+            using (var other = new JavascriptContext())
+            {
+                var script = first.Compile("1");
+
+                Action action = () => script.Run(other);
+
+                action.ShouldThrow<ArgumentException>();
+            }
+        }
+
+        [TestMethod]
+        public void DisposingTheIsolateDisposesItsContexts()
+        {
+            var context = _isolate.CreateContext();
+            _isolate.ContextCount.Should().Be(1);
+
+            _isolate.Dispose();
+
+            _isolate.ContextCount.Should().Be(0);
+            Action action = () => _isolate.CreateContext();
+            action.ShouldThrow<ObjectDisposedException>();
+        }
+
+        [TestMethod]
+        public void DisposingTheIsolateDisposesFunctionsOfItsContexts()
+        {
+            var context = _isolate.CreateContext();
+            var function = (JavascriptFunction)context.Run("(function () { return 1; })");
+            // Long enough for leaving the scopes to sample the heap again.
+            Thread.Sleep(150);
+
+            Action action = () => _isolate.Dispose();
+
+            action.ShouldNotThrow();
+        }
+
+        [TestMethod]
+        public void DisposingAContextLeavesTheIsolateUsable()
+        {
+            _isolate.CreateContext().Dispose();
+
+            using (var context = _isolate.CreateContext())
+                context.Run("1 + 1").Should().Be(2);
+        }
+    }
+}
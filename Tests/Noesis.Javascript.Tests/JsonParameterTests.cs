@@ -0,0 +1,88 @@
+﻿using System;
+using System.Text;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class JsonParameterTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void SetParameterJsonParsesIntoJavascriptValues()
+        {
+            _context.SetParameterJson("order", Encoding.UTF8.GetBytes("{\"lines\": [{\"qty\": 2}, {\"qty\": 3}], \"note\": \"café €\"}"));
+
+            _context.Run("order.lines[0].qty + order.lines[1].qty").Should().Be(5);
+            _context.Run("order.note").Should().Be("café €");
+        }
+
+        [TestMethod]
+        public void GetParameterJsonStringifiesAsUtf8()
+        {
+            _context.Run("var order = { id: 7, tags: ['a', '€'] };");
+
+            Encoding.UTF8.GetString(_context.GetParameterJson("order")).Should().Be("{\"id\":7,\"tags\":[\"a\",\"€\"]}");
+        }
+
+        [TestMethod]
+        public void SetParameterJsonSkipsAByteOrderMark()
+        {
+            _context.SetParameterJson("value", new byte[] { 0xEF, 0xBB, 0xBF, (byte)'[', (byte)'1', (byte)']' });
+
+            _context.Run("value[0]").Should().Be(1);
+        }
+
+        [TestMethod]
+        public void SetParameterJsonRejectsInvalidJson()
+        {
+            Action action = () => _context.SetParameterJson("value", Encoding.UTF8.GetBytes("{oops}"));
+
+            action.ShouldThrow<JavascriptException>().Which.Message.Should().Contain("SyntaxError");
+        }
+
+        [TestMethod]
+        public void GetParameterJsonIsNullWithoutJson()
+        {
+            _context.Run("var f = function () {};");
+
+            _context.GetParameterJson("missing").Should().BeNull();
+            _context.GetParameterJson("f").Should().BeNull();
+        }
+
+        [TestMethod]
+        public void GetParameterJsonThrowsOnCycles()
+        {
+            _context.Run("var a = {}; a.self = a;");
+
+            Action action = () => _context.GetParameterJson("a");
+
+            action.ShouldThrow<JavascriptException>().Which.Message.Should().Contain("TypeError");
+        }
+
+        [TestMethod]
+        public void SessionsTransferJsonToo()
+        {
+            using (var session = _context.BeginSession())
+            {
+                session.SetParameterJson("a", Encoding.UTF8.GetBytes("{\"x\": 1}"));
+                session.Run("a.x++;");
+                Encoding.UTF8.GetString(session.GetParameterJson("a")).Should().Be("{\"x\":2}");
+            }
+        }
+    }
+}
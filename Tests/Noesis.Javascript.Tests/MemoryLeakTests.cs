@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Diagnostics;
+using System.Runtime.CompilerServices;
 using Microsoft.VisualStudio.TestTools.UnitTesting;
 using FluentAssertions;
 
@@ -24,6 +25,47 @@ namespace Noesis.Javascript.Tests
             diffMBytes.Should().BeLessThan(1, String.Format("{0:0.00}MB left allocated", diffMBytes));
         }
 
+        [TestMethod]
+        public void WrappedObjectsAreReleasedOnceJavascriptDropsThem()
+        {
+            using (JavascriptContext ctx = new JavascriptContext()) {
+                WeakReference dropped = SetAndDrop(ctx, () => new object());
+                object kept = new object();
+                ctx.SetParameter("kept", kept);
+
+                ctx.Collect();
+                GC.Collect();
+                GC.WaitForPendingFinalizers();
+
+                dropped.IsAlive.Should().BeFalse();
+                ctx.GetParameter("kept").Should().BeSameAs(kept);
+            }
+        }
+
+        [TestMethod]
+        public void WrappedDelegatesAreReleasedOnceJavascriptDropsThem()
+        {
+            using (JavascriptContext ctx = new JavascriptContext()) {
+                int one = 1;
+                WeakReference dropped = SetAndDrop(ctx, () => new Func<int>(() => one));
+
+                ctx.Collect();
+                GC.Collect();
+                GC.WaitForPendingFinalizers();
+
+                dropped.IsAlive.Should().BeFalse();
+            }
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static WeakReference SetAndDrop(JavascriptContext ctx, Func<object> create)
+        {
+            object value = create();
+            ctx.SetParameter("value", value);
+            ctx.Run("value = null;");
+            return new WeakReference(value);
+        }
+
         private static void MemoryUsageLoadInstance()
         {
             using (JavascriptContext ctx = new JavascriptContext()) {
@@ -0,0 +1,140 @@
+﻿using System;
+using System.Diagnostics;
+using System.Runtime.CompilerServices;
+using System.Threading;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class MemoryManagerTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            JavascriptMemoryManager.IdleCollectionEnabled = false;
+            JavascriptMemoryManager.IdleCollectionDelay = TimeSpan.FromSeconds(1);
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void CollectFreesGarbage()
+        {
+            _context.Run("var big = []; for (var i = 0; i < 100000; i++) big.push({ i: i }); big = null;");
+            long before = _context.GetHeapStatistics().UsedHeapSize;
+
+            _context.Collect();
+
+            _context.GetHeapStatistics().UsedHeapSize.Should().BeLessThan(before);
+        }
+
+        [TestMethod]
+        public void NotifyLowMemoryCollectsIdleIsolates()
+        {
+            _context.Run("var big = []; for (var i = 0; i < 100000; i++) big.push({ i: i }); big = null;");
+            long before = _context.GetHeapStatistics().UsedHeapSize;
+            long notifications = JavascriptMemoryManager.LowMemoryNotifications;
+
+            JavascriptMemoryManager.NotifyLowMemory();
+
+            _context.GetHeapStatistics().UsedHeapSize.Should().BeLessThan(before);
+            JavascriptMemoryManager.LowMemoryNotifications.Should().Be(notifications + 1);
+        }
+
+        [TestMethod]
+        public void IdleIsolatesAreCollectedInTheBackground()
+        {
+            long collections = JavascriptMemoryManager.IdleCollections;
+            _context.Run("var big = []; for (var i = 0; i < 100000; i++) big.push({ i: i }); big = null;");
+
+            JavascriptMemoryManager.IdleCollectionDelay = TimeSpan.Zero;
+            JavascriptMemoryManager.IdleCollectionEnabled = true;
+
+            var stopwatch = Stopwatch.StartNew();
+            while (JavascriptMemoryManager.IdleCollections == collections && stopwatch.Elapsed < TimeSpan.FromSeconds(5))
+                Thread.Sleep(10);
+            JavascriptMemoryManager.IdleCollections.Should().BeGreaterThan(collections);
+
+            // Contexts remain usable.
+            _context.Run("1 + 1").Should().Be(2);
+        }
+
+        [TestMethod]
+        public void AbandonedContextsCanBeFinalized()
+        {
+            int before = CollectAndCountIsolates();
+            WeakReference context = AbandonContext();
+
+            int after = CollectAndCountIsolates();
+
+            context.IsAlive.Should().BeFalse();
+            after.Should().BeLessOrEqualTo(before, "the finalizer should have torn the isolate down");
+        }
+
+        // Finalizers are what take isolates off the list, so this only
+        // goes down once they have run.
+        private static int CollectAndCountIsolates()
+        {
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            return JavascriptIsolate.GetUnfinalizedCount();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static WeakReference AbandonContext()
+        {
+            var context = new JavascriptContext();
+            context.Run("var x = {};");
+            return new WeakReference(context);
+        }
+
+        class Poco
+        {
+            public int Id { get; set; }
+        }
+
+        [TestMethod]
+        public void AbandonedContextsThatWrappedObjectsCanBeFinalized()
+        {
+            int before = CollectAndCountIsolates();
+            WeakReference isolate;
+            WeakReference context = AbandonContextWithWrappers(out isolate);
+
+            int after = CollectAndCountIsolates();
+
+            context.IsAlive.Should().BeFalse();
+            isolate.IsAlive.Should().BeFalse();
+            after.Should().BeLessOrEqualTo(before, "the finalizer should have torn the isolate down");
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private static WeakReference AbandonContextWithWrappers(out WeakReference isolate)
+        {
+            var context = new JavascriptContext();
+            context.SetParameter("poco", new Poco { Id = 1 });
+            context.SetParameter("callback", new Func<int>(() => 2));
+            context.Run("poco.Id + callback()");
+            isolate = new WeakReference(context.Isolate);
+            return new WeakReference(context);
+        }
+
+        [TestMethod]
+        public void IdleCollectionBudgetMustBePositive()
+        {
+            Action action = () => JavascriptMemoryManager.IdleCollectionBudget = TimeSpan.Zero;
+
+            action.ShouldThrow<ArgumentOutOfRangeException>();
+        }
+    }
+}
@@ -0,0 +1,104 @@
+﻿using System;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class MethodInvocationTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        class Overloads
+        {
+            public string Describe(int i) { return "int " + i; }
+            public string Describe(string s) { return "string " + s; }
+            public string Describe(string s, int i) { return "string " + s + " int " + i; }
+
+            public int Calls;
+            public void Count() { Calls++; }
+
+            public int AddOne(int i) { return i + 1; }
+
+            public void Fail() { throw new InvalidOperationException("Failed on purpose"); }
+        }
+
+        [TestMethod]
+        public void RepeatedCallsKeepChoosingTheRightOverload()
+        {
+            _context.SetParameter("o", new Overloads());
+
+            for (int i = 0; i < 3; i++)
+            {
+                _context.Run("o.Describe(1)").Should().Be("int 1");
+                _context.Run("o.Describe('a')").Should().Be("string a");
+                _context.Run("o.Describe('a', 2)").Should().Be("string a int 2");
+            }
+        }
+
+        [TestMethod]
+        public void VoidMethodsAreCalledEachTime()
+        {
+            var overloads = new Overloads();
+            _context.SetParameter("o", overloads);
+
+            _context.Run("for (var i = 0; i < 10; i++) o.Count();");
+
+            overloads.Calls.Should().Be(10);
+        }
+
+        [TestMethod]
+        public void NullIsPassedAsTheDefaultForValueTypes()
+        {
+            _context.SetParameter("o", new Overloads());
+
+            _context.Run("o.AddOne(1)").Should().Be(2);
+            _context.Run("o.AddOne(null)").Should().Be(1);
+        }
+
+        [TestMethod]
+        public void ArgumentsAreConvertedOnEveryCall()
+        {
+            _context.SetParameter("o", new Overloads());
+
+            _context.Run("o.AddOne('41')").Should().Be(42);
+            _context.Run("o.AddOne('1')").Should().Be(2);
+            _context.Run("o.AddOne(2.5)").Should().Be(3);
+        }
+
+        [TestMethod]
+        public void ExceptionsReachJavascriptUnwrapped()
+        {
+            _context.SetParameter("o", new Overloads());
+
+            for (int i = 0; i < 2; i++)
+                _context.Run("try { o.Fail(); '' } catch (e) { e.message }").Should().Be("Failed on purpose");
+        }
+
+        struct Counter
+        {
+            public int Value;
+            public void Increment() { Value++; }
+        }
+
+        [TestMethod]
+        public void MethodsOnStructsSeeTheirOwnChanges()
+        {
+            _context.SetParameter("c", new Counter());
+
+            _context.Run("c.Increment(); c.Increment(); c.Value").Should().Be(2);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+﻿using System;
+using System.Threading.Tasks;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class PlatformTests
+    {
+        // The platform is set up once per process, by whichever test creates
+        // the first context, so all we can check here is that it then stays
+        // put.
+        [TestMethod]
+        public void SettingsAreFrozenOnceV8IsInitialised()
+        {
+            using (new JavascriptContext())
+            {
+                JavascriptPlatform.IsInitialised.Should().BeTrue();
+
+                Action threads = () => JavascriptPlatform.WorkerThreadCount = 2;
+                Action idle = () => JavascriptPlatform.IdleTasksEnabled = true;
+                Action scheduler = () => JavascriptPlatform.WorkerTaskScheduler = TaskScheduler.Default;
+
+                threads.ShouldThrow<InvalidOperationException>();
+                idle.ShouldThrow<InvalidOperationException>();
+                scheduler.ShouldThrow<InvalidOperationException>();
+            }
+        }
+
+        [TestMethod]
+        public void RunIdleTasksRequiresIdleTaskSupport()
+        {
+            using (var context = new JavascriptContext())
+            {
+                Action action = () => context.Isolate.RunIdleTasks(TimeSpan.FromMilliseconds(10));
+
+                if (JavascriptPlatform.IdleTasksEnabled)
+                    action.ShouldNotThrow();
+                else
+                    action.ShouldThrow<InvalidOperationException>();
+            }
+        }
+    }
+}
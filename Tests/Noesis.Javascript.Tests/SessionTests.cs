@@ -0,0 +1,120 @@
+﻿using System;
+using System.Threading.Tasks;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class SessionTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void SessionSupportsTheUsualOperations()
+        {
+            using (var session = _context.BeginSession())
+            {
+                session.SetParameter("a", 2);
+                session.SetParameter("b", 3);
+                session.Run("var c = a * b;");
+                session.GetParameter("c").Should().Be(6);
+
+                var add = (JavascriptFunction)session.Run("(function (x, y) { return x + y; })");
+                session.Call(add, 4, 5).Should().Be(9);
+            }
+        }
+
+        [TestMethod]
+        public void SessionAndContextSeeTheSameGlobals()
+        {
+            using (var session = _context.BeginSession())
+            {
+                session.SetParameter("x", 10);
+                _context.Run("x + 1").Should().Be(11);
+            }
+            _context.GetParameter("x").Should().Be(10);
+        }
+
+        [TestMethod]
+        public void ScriptErrorsLeaveTheSessionUsable()
+        {
+            using (var session = _context.BeginSession())
+            {
+                Action action = () => session.Run("throw new Error('oops')");
+                action.ShouldThrow<JavascriptException>();
+
+                session.Run("1 + 1").Should().Be(2);
+            }
+        }
+
+        [TestMethod]
+        public void SessionCannotBeUsedFromAnotherThread()
+        {
+            using (var session = _context.BeginSession())
+            {
+                var other = Task.Run(() => session.Run("1"));
+
+                Action action = () => other.Wait();
+
+                action.ShouldThrow<AggregateException>().WithInnerException<InvalidOperationException>();
+            }
+        }
+
+        [TestMethod]
+        public void DisposingOnAnotherThreadLeavesTheSessionOpen()
+        {
+            using (var session = _context.BeginSession())
+            {
+                Action action = () => Task.Run(() => session.Dispose()).Wait();
+
+                action.ShouldNotThrow();
+                session.Run("1 + 1").Should().Be(2);
+            }
+            Task.Run(() => _context.Run("2 + 2")).Result.Should().Be(4);
+        }
+
+        [TestMethod]
+        public void NestedSessionsCanBeDisposedOutOfOrder()
+        {
+            using (var isolate = new JavascriptIsolate())
+            using (var first = isolate.CreateContext())
+            using (var second = isolate.CreateContext())
+            {
+                var outer = first.BeginSession();
+                var inner = second.BeginSession();
+                inner.SetParameter("x", 1);
+
+                outer.Dispose();
+                inner.Run("x + 1").Should().Be(2);
+                inner.Dispose();
+
+                Task.Run(() => first.Run("3")).Result.Should().Be(3);
+                second.GetParameter("x").Should().Be(1);
+            }
+        }
+
+        [TestMethod]
+        public void SessionCannotBeUsedAfterDisposal()
+        {
+            var session = _context.BeginSession();
+            session.Dispose();
+
+            Action action = () => session.Run("1");
+
+            action.ShouldThrow<ObjectDisposedException>();
+        }
+    }
+}
@@ -0,0 +1,65 @@
+﻿using System;
+using System.IO;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class SnapshotTests
+    {
+        const string Bootstrap = "function double(x) { return x * 2; } var library = { version: 3 };";
+
+        [TestMethod]
+        public void ContextStartsWithBootstrapGlobals()
+        {
+            var snapshot = JavascriptSnapshot.Create(Bootstrap);
+            using (var context = new JavascriptContext(snapshot)) {
+                context.Run("double(library.version)").Should().Be(6);
+            }
+        }
+
+        [TestMethod]
+        public void SnapshotSurvivesRoundTripThroughDisk()
+        {
+            string path = Path.GetTempFileName();
+            try {
+                JavascriptSnapshot.Create(Bootstrap).Save(path);
+                var loaded = JavascriptSnapshot.Load(path);
+                using (var context = new JavascriptContext(loaded)) {
+                    context.Run("double(21)").Should().Be(42);
+                }
+            } finally {
+                File.Delete(path);
+            }
+        }
+
+        [TestMethod]
+        public void BootstrapErrorsAreReported()
+        {
+            Action action = () => JavascriptSnapshot.Create("throw new Error('no good')");
+            action.ShouldThrow<JavascriptException>().WithMessage("Error: no good");
+        }
+
+        [TestMethod]
+        public void ForeignBlobsAreRejected()
+        {
+            Action action = () => JavascriptSnapshot.FromArray(new byte[] { 1, 2, 3 });
+            action.ShouldThrow<ArgumentException>();
+        }
+
+        [TestMethod]
+        public void PooledContextsAreResetToTheSnapshot()
+        {
+            using (var pool = new JavascriptContextPool(1, 1, TimeSpan.FromMinutes(1), JavascriptSnapshot.Create(Bootstrap))) {
+                var context = pool.Acquire();
+                context.Run("library.version = 4");
+                pool.Release(context);
+
+                context = pool.Acquire();
+                context.Run("library.version").Should().Be(3);
+                pool.Release(context);
+            }
+        }
+    }
+}
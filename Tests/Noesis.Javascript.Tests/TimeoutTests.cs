@@ -0,0 +1,88 @@
+﻿using System;
+using System.Threading.Tasks;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class TimeoutTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        [TestMethod]
+        public void InfiniteLoopIsStoppedAfterTheTimeout()
+        {
+            Action action = () => _context.Run("while (true) {}", TimeSpan.FromMilliseconds(100));
+
+            var exception = action.ShouldThrowExactly<JavascriptTimeoutException>().Which;
+            exception.Timeout.Should().Be(TimeSpan.FromMilliseconds(100));
+            exception.Elapsed.Should().BeGreaterOrEqualTo(TimeSpan.FromMilliseconds(100));
+            exception.CpuTime.Should().BeGreaterThan(TimeSpan.Zero);
+        }
+
+        [TestMethod]
+        public void ContextIsUsableAfterATimeout()
+        {
+            try
+            {
+                _context.Run("while (true) {}", "loop.js", TimeSpan.FromMilliseconds(50));
+            }
+            catch (JavascriptTimeoutException)
+            {
+            }
+
+            _context.Run("1 + 1").Should().Be(2);
+        }
+
+        [TestMethod]
+        public void ScriptsThatFinishInTimeReturnNormally()
+        {
+            _context.Run("6 * 7", TimeSpan.FromSeconds(10)).Should().Be(42);
+        }
+
+        [TestMethod]
+        public void FunctionCallsCanTimeOut()
+        {
+            var spin = (JavascriptFunction)_context.Run("(function (n) { while (true) {} })");
+
+            Action action = () => spin.Call(TimeSpan.FromMilliseconds(50), new object[] { 1 });
+
+            action.ShouldThrowExactly<JavascriptTimeoutException>();
+        }
+
+        [TestMethod]
+        public void OnlyTheIsolateOverBudgetIsStopped()
+        {
+            using (var patient = new JavascriptContext())
+            {
+                var slow = Task.Run(() => patient.Run("var end = Date.now() + 300; while (Date.now() < end) {} 'done'", TimeSpan.FromSeconds(10)));
+
+                Action action = () => _context.Run("while (true) {}", TimeSpan.FromMilliseconds(50));
+
+                action.ShouldThrowExactly<JavascriptTimeoutException>();
+                slow.Result.Should().Be("done");
+            }
+        }
+
+        [TestMethod]
+        public void NonPositiveTimeoutIsRejected()
+        {
+            Action action = () => _context.Run("1", TimeSpan.Zero);
+
+            action.ShouldThrow<ArgumentOutOfRangeException>();
+        }
+    }
+}
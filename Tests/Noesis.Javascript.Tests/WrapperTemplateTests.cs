@@ -0,0 +1,199 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Collections.ObjectModel;
+using FluentAssertions;
+using Microsoft.VisualStudio.TestTools.UnitTesting;
+
+namespace Noesis.Javascript.Tests
+{
+    [TestClass]
+    public class WrapperTemplateTests
+    {
+        private JavascriptContext _context;
+
+        [TestInitialize]
+        public void SetUp()
+        {
+            _context = new JavascriptContext();
+        }
+
+        [TestCleanup]
+        public void TearDown()
+        {
+            _context.Dispose();
+        }
+
+        class Product
+        {
+            public string Name { get; set; }
+            public decimal Price { get; set; }
+            public decimal Discounted(decimal percent) { return Price * (100 - percent) / 100; }
+            public override string ToString() { return "Product " + Name; }
+        }
+
+        [TestMethod]
+        public void ObjectKeysListsProperties()
+        {
+            _context.SetParameter("product", new Product { Name = "Tea", Price = 2 });
+
+            var keys = (object[])_context.Run("Object.keys(product)");
+
+            keys.Should().BeEquivalentTo(new object[] { "Name", "Price" });
+        }
+
+        [TestMethod]
+        public void ForInAndJsonStringifySeeProperties()
+        {
+            _context.SetParameter("product", new Product { Name = "Tea", Price = 2 });
+
+            _context.Run("var names = []; for (var name in product) names.push(name); names.join()").Should().Be("Name,Price");
+            _context.Run("JSON.stringify(product)").Should().Be("{\"Name\":\"Tea\",\"Price\":2}");
+        }
+
+        [TestMethod]
+        public void IndexersAreNotEnumeratedAsProperties()
+        {
+            _context.SetParameter("list", new List<int> { 1, 2 });
+            _context.SetParameter("collection", new Collection<int> { 1, 2 });
+
+            _context.Run("JSON.stringify(list)").Should().Be("[1,2]");
+            _context.Run("Object.keys(collection).join()").Should().Be("Count");
+            _context.Run("JSON.stringify(collection)").Should().Be("{\"Count\":2}");
+            _context.Run("collection[1]").Should().Be(2);
+        }
+
+        class Faulty
+        {
+            public int Broken { get { throw new InvalidOperationException("broken"); } }
+        }
+
+        [TestMethod]
+        public void EnumeratingPropertiesRunsTheirGetters()
+        {
+            _context.SetParameter("faulty", new Faulty());
+
+            _context.Run("Object.keys(faulty).join()").Should().Be("Broken");
+            Action action = () => _context.Run("JSON.stringify(faulty)");
+            action.ShouldThrow<JavascriptException>().Which.Message.Should().Contain("broken");
+        }
+
+        [TestMethod]
+        public void ObjectsOfTheSameTypeShareAPrototype()
+        {
+            _context.SetParameter("a", new Product());
+            _context.SetParameter("b", new Product());
+
+            _context.Run("Object.getPrototypeOf(a) === Object.getPrototypeOf(b) && a.Discounted === b.Discounted").Should().Be(true);
+        }
+
+        [TestMethod]
+        public void MethodsCalledInALoopUseTheirOwnObject()
+        {
+            _context.SetParameter("products", new[] { new Product { Price = 10 }, new Product { Price = 20 } });
+
+            _context.Run("var total = 0; for (var i = 0; i < 100; i++) total += products[i % 2].Discounted(50); total").Should().Be(750.0);
+        }
+
+        [TestMethod]
+        public void ToStringMapsToTheDotNetMethod()
+        {
+            _context.SetParameter("product", new Product { Name = "Tea" });
+
+            _context.Run("'' + product.toString()").Should().Be("Product Tea");
+        }
+
+        [TestMethod]
+        public void MethodsNeedAWrappedObjectAsThis()
+        {
+            _context.SetParameter("product", new Product());
+
+            _context.Run("var f = product.Discounted; try { f(10); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+        }
+
+        [TestMethod]
+        public void ExpandoPropertiesStillWork()
+        {
+            _context.SetParameter("product", new Product());
+
+            _context.Run("product.extra = 5; product.extra").Should().Be(5);
+        }
+
+        class Bag
+        {
+            private readonly Dictionary<string, object> _values = new Dictionary<string, object>();
+            public object this[string key]
+            {
+                get { object value; _values.TryGetValue(key, out value); return value; }
+                set { _values[key] = value; }
+            }
+            public int Size() { return _values.Count; }
+        }
+
+        [TestMethod]
+        public void StringIndexedTypesSeeEveryName()
+        {
+            var bag = new Bag();
+            _context.SetParameter("bag", bag);
+
+            _context.Run("bag.valueOf = 3; bag.anything = 'x'");
+
+            bag["valueOf"].Should().Be(3);
+            bag["anything"].Should().Be("x");
+        }
+
+        [TestMethod]
+        public void StringIndexedTypesShareMethodsPerType()
+        {
+            var first = new Bag();
+            first["a"] = 1;
+            _context.SetParameter("first", first);
+            _context.SetParameter("second", new Bag());
+
+            _context.Run("first.Size === second.Size").Should().Be(true);
+            _context.Run("[first.Size(), second.Size()]").Should().BeEquivalentTo(new object[] { 1, 0 });
+        }
+
+        [TestMethod]
+        public void SharedMethodsTakeTheirObjectFromThis()
+        {
+            var first = new Bag();
+            first["a"] = 1;
+            _context.SetParameter("first", first);
+            _context.SetParameter("second", new Bag());
+
+            _context.Run("second.Size.call(first)").Should().Be(1);
+            _context.Run("try { second.Size.call({}); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+        }
+
+        class Shelf
+        {
+            public object this[string key] { get { return null; } set { } }
+            public int Size() { return -1; }
+        }
+
+        [TestMethod]
+        public void SharedMethodsRejectObjectsOfOtherTypes()
+        {
+            _context.SetParameter("bag", new Bag());
+            _context.SetParameter("shelf", new Shelf());
+            _context.SetParameter("product", new Product());
+
+            _context.Run("try { bag.Size.call(new Uint8Array(1)); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+            _context.Run("try { bag.Size.call(new ArrayBuffer(8)); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+            _context.Run("try { bag.Size.call(shelf); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+            _context.Run("try { bag.Size.call(product); 'called' } catch (e) { e instanceof TypeError }").Should().Be(true);
+        }
+
+        [TestMethod]
+        public void StringIndexedTypesSeeMoreNamesThanAreRemembered()
+        {
+            var bag = new Bag();
+            _context.SetParameter("bag", bag);
+
+            _context.Run("for (var i = 0; i < 5000; i++) bag['k' + i] = i;");
+
+            _context.Run("var sum = 0; for (var i = 0; i < 5000; i++) sum += bag['k' + i]; sum").Should().Be(12497500);
+            bag["k4999"].Should().Be(4999);
+        }
+    }
+}